@@ -0,0 +1,354 @@
+// BatchFill.cpp
+#include "BatchFill.h"
+#include "RandomEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <iterator>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCHFILL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BATCHFILL_TARGET(features)
+#else
+#define BATCHFILL_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+namespace {
+using State = quint64[4][BatchFill::Lanes];
+
+// 第 lane 路前进一步(xoshiro256**)
+inline quint64 nextLane(State &s, int lane)
+{
+    const quint64 result = std::rotl(s[1][lane] * 5, 7) * 9;
+    const quint64 t = s[1][lane] << 17;
+
+    s[2][lane] ^= s[0][lane];
+    s[3][lane] ^= s[1][lane];
+    s[1][lane] ^= s[2][lane];
+    s[0][lane] ^= s[3][lane];
+    s[2][lane] ^= t;
+    s[3][lane] = std::rotl(s[3][lane], 45);
+
+    return result;
+}
+
+// 与 boundedRandom() 相同的 Lemire 映射，threshold = 2^64 mod range
+inline quint64 boundedLane(State &s, int lane, quint64 range, quint64 threshold)
+{
+    quint64 low;
+    quint64 high = mulHigh64(nextLane(s, lane), range, &low);
+    while (low < threshold) {
+        high = mulHigh64(nextLane(s, lane), range, &low);
+    }
+    return high;
+}
+
+// 向量实现中某组出现拒绝时调用：s 为该组之后的状态，被拒绝的路在本路继续抽取
+void redrawRejected(State &s, unsigned mask, qint64 *out, quint64 range, quint64 threshold, quint64 offset)
+{
+    while (mask) {
+        const int lane = std::countr_zero(mask);
+        mask &= mask - 1;
+        out[lane] = qint64(offset + boundedLane(s, lane, range, threshold));
+    }
+}
+
+void fillScalar(State &s, qint64 *out, qint64 groups, quint64 range, quint64 threshold, quint64 offset)
+{
+    for (qint64 g = 0; g < groups; ++g, out += BatchFill::Lanes) {
+        for (int lane = 0; lane < BatchFill::Lanes; ++lane) {
+            out[lane] = qint64(offset + boundedLane(s, lane, range, threshold));
+        }
+    }
+}
+
+#ifdef BATCHFILL_X86
+template <int Bits>
+BATCHFILL_TARGET("avx2") inline __m256i rotlAvx2(__m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, Bits), _mm256_srli_epi64(x, 64 - Bits));
+}
+
+// 64x64 -> 128 位乘法(AVX2 只有 32x32 -> 64)，rangeHigh 为 range 的高 32 位
+BATCHFILL_TARGET("avx2") inline void mulAvx2(__m256i x, __m256i range, __m256i rangeHigh,
+                                             __m256i &high, __m256i &low)
+{
+    const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+    const __m256i xHigh = _mm256_srli_epi64(x, 32);
+    const __m256i ll = _mm256_mul_epu32(x, range);
+    const __m256i lh = _mm256_mul_epu32(x, rangeHigh);
+    const __m256i hl = _mm256_mul_epu32(xHigh, range);
+    const __m256i hh = _mm256_mul_epu32(xHigh, rangeHigh);
+    const __m256i mid = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(ll, 32), _mm256_and_si256(lh, mask)),
+                                         _mm256_and_si256(hl, mask));
+    high = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(lh, 32)),
+                            _mm256_add_epi64(_mm256_srli_epi64(hl, 32), _mm256_srli_epi64(mid, 32)));
+    low = _mm256_or_si256(_mm256_slli_epi64(mid, 32), _mm256_and_si256(ll, mask));
+}
+
+// 每组 8 路分成两个 256 位寄存器
+BATCHFILL_TARGET("avx2")
+void fillAvx2(State &s, qint64 *out, qint64 groups, quint64 range, quint64 threshold, quint64 offset)
+{
+    __m256i v[4][2];
+    for (int w = 0; w < 4; ++w) {
+        for (int h = 0; h < 2; ++h) {
+            v[w][h] = _mm256_load_si256(reinterpret_cast<const __m256i *>(&s[w][4 * h]));
+        }
+    }
+
+    const __m256i rangeV = _mm256_set1_epi64x(qint64(range));
+    const __m256i rangeHigh = _mm256_set1_epi64x(qint64(range >> 32));
+    // AVX2 只有有符号比较，两边同时翻转符号位后比较
+    const __m256i sign = _mm256_set1_epi64x(qint64(1ULL << 63));
+    const __m256i thresholdV = _mm256_set1_epi64x(qint64(threshold ^ (1ULL << 63)));
+    const __m256i offsetV = _mm256_set1_epi64x(qint64(offset));
+
+    for (qint64 g = 0; g < groups; ++g, out += BatchFill::Lanes) {
+        unsigned rejected = 0;
+        for (int h = 0; h < 2; ++h) {
+            __m256i &s0 = v[0][h];
+            __m256i &s1 = v[1][h];
+            __m256i &s2 = v[2][h];
+            __m256i &s3 = v[3][h];
+
+            const __m256i times5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            const __m256i rotated = rotlAvx2<7>(times5);
+            const __m256i x = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotlAvx2<45>(s3);
+
+            __m256i high, low;
+            mulAvx2(x, rangeV, rangeHigh, high, low);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * h), _mm256_add_epi64(high, offsetV));
+
+            const __m256i reject = _mm256_cmpgt_epi64(thresholdV, _mm256_xor_si256(low, sign));
+            rejected |= unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(reject))) << (4 * h);
+        }
+
+        if (rejected) {
+            for (int w = 0; w < 4; ++w) {
+                for (int h = 0; h < 2; ++h) {
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(&s[w][4 * h]), v[w][h]);
+                }
+            }
+            redrawRejected(s, rejected, out, range, threshold, offset);
+            for (int w = 0; w < 4; ++w) {
+                for (int h = 0; h < 2; ++h) {
+                    v[w][h] = _mm256_load_si256(reinterpret_cast<const __m256i *>(&s[w][4 * h]));
+                }
+            }
+        }
+    }
+
+    for (int w = 0; w < 4; ++w) {
+        for (int h = 0; h < 2; ++h) {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(&s[w][4 * h]), v[w][h]);
+        }
+    }
+}
+
+BATCHFILL_TARGET("avx512f") inline void mulAvx512(__m512i x, __m512i range, __m512i rangeHigh,
+                                                  __m512i &high, __m512i &low)
+{
+    const __m512i mask = _mm512_set1_epi64(0xFFFFFFFF);
+    const __m512i xHigh = _mm512_srli_epi64(x, 32);
+    const __m512i ll = _mm512_mul_epu32(x, range);
+    const __m512i lh = _mm512_mul_epu32(x, rangeHigh);
+    const __m512i hl = _mm512_mul_epu32(xHigh, range);
+    const __m512i hh = _mm512_mul_epu32(xHigh, rangeHigh);
+    const __m512i mid = _mm512_add_epi64(_mm512_add_epi64(_mm512_srli_epi64(ll, 32), _mm512_and_si512(lh, mask)),
+                                         _mm512_and_si512(hl, mask));
+    high = _mm512_add_epi64(_mm512_add_epi64(hh, _mm512_srli_epi64(lh, 32)),
+                            _mm512_add_epi64(_mm512_srli_epi64(hl, 32), _mm512_srli_epi64(mid, 32)));
+    low = _mm512_or_si512(_mm512_slli_epi64(mid, 32), _mm512_and_si512(ll, mask));
+}
+
+// 每组 8 路正好是一个 512 位寄存器
+BATCHFILL_TARGET("avx512f")
+void fillAvx512(State &s, qint64 *out, qint64 groups, quint64 range, quint64 threshold, quint64 offset)
+{
+    __m512i s0 = _mm512_load_si512(s[0]);
+    __m512i s1 = _mm512_load_si512(s[1]);
+    __m512i s2 = _mm512_load_si512(s[2]);
+    __m512i s3 = _mm512_load_si512(s[3]);
+
+    const __m512i rangeV = _mm512_set1_epi64(qint64(range));
+    const __m512i rangeHigh = _mm512_set1_epi64(qint64(range >> 32));
+    const __m512i thresholdV = _mm512_set1_epi64(qint64(threshold));
+    const __m512i offsetV = _mm512_set1_epi64(qint64(offset));
+
+    for (qint64 g = 0; g < groups; ++g, out += BatchFill::Lanes) {
+        const __m512i times5 = _mm512_add_epi64(_mm512_slli_epi64(s1, 2), s1);
+        const __m512i rotated = _mm512_rol_epi64(times5, 7);
+        const __m512i x = _mm512_add_epi64(_mm512_slli_epi64(rotated, 3), rotated);
+        const __m512i t = _mm512_slli_epi64(s1, 17);
+
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_rol_epi64(s3, 45);
+
+        __m512i high, low;
+        mulAvx512(x, rangeV, rangeHigh, high, low);
+        _mm512_storeu_si512(out, _mm512_add_epi64(high, offsetV));
+
+        const __mmask8 rejected = _mm512_cmplt_epu64_mask(low, thresholdV);
+        if (rejected) {
+            _mm512_store_si512(s[0], s0);
+            _mm512_store_si512(s[1], s1);
+            _mm512_store_si512(s[2], s2);
+            _mm512_store_si512(s[3], s3);
+            redrawRejected(s, rejected, out, range, threshold, offset);
+            s0 = _mm512_load_si512(s[0]);
+            s1 = _mm512_load_si512(s[1]);
+            s2 = _mm512_load_si512(s[2]);
+            s3 = _mm512_load_si512(s[3]);
+        }
+    }
+
+    _mm512_store_si512(s[0], s0);
+    _mm512_store_si512(s[1], s1);
+    _mm512_store_si512(s[2], s2);
+    _mm512_store_si512(s[3], s3);
+}
+#endif
+
+BatchFill::Kernel detectKernel()
+{
+#if defined(BATCHFILL_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return BatchFill::Kernel::Scalar;
+    }
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27))) { // OSXSAVE
+        return BatchFill::Kernel::Scalar;
+    }
+    // 还需要操作系统保存 YMM / ZMM 寄存器
+    const quint64 xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) {
+        return BatchFill::Kernel::Avx512;
+    }
+    if ((info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6) {
+        return BatchFill::Kernel::Avx2;
+    }
+#elif defined(BATCHFILL_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return BatchFill::Kernel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return BatchFill::Kernel::Avx2;
+    }
+#endif
+    return BatchFill::Kernel::Scalar;
+}
+
+std::atomic<BatchFill::Kernel> &activeKernelStorage()
+{
+    static std::atomic<BatchFill::Kernel> kernel{BatchFill::supportedKernel()};
+    return kernel;
+}
+}
+
+BatchFill::BatchFill(quint64 seed, quint64 stream)
+{
+    // 与 Xoshiro256StarStar 相同的方式混入流号，第 0 路的状态与 Xoshiro256StarStar(seed, stream) 相同
+    SplitMix64 mixer(seed ^ SplitMix64(stream ^ 0xD1B54A32D192ED03ULL)());
+    for (int lane = 0; lane < Lanes; ++lane) {
+        for (int word = 0; word < 4; ++word) {
+            m_state[word][lane] = mixer();
+        }
+    }
+}
+
+void BatchFill::fill(std::span<qint64> out, quint64 range, qint64 offset)
+{
+    Q_ASSERT(range != 0);
+    const quint64 threshold = (0 - range) % range;
+    const quint64 base = quint64(offset);
+    qint64 *data = out.data();
+    qint64 remaining = qint64(out.size());
+
+    // 先用标量补齐到组边界，整组交给向量实现，最后不足一组的部分再用标量
+    for (; remaining > 0 && m_lane != 0; --remaining) {
+        *data++ = qint64(base + boundedLane(m_state, m_lane, range, threshold));
+        m_lane = (m_lane + 1) % Lanes;
+    }
+
+    const qint64 groups = remaining / Lanes;
+    switch (activeKernel()) {
+#ifdef BATCHFILL_X86
+    case Kernel::Avx512:
+        fillAvx512(m_state, data, groups, range, threshold, base);
+        break;
+    case Kernel::Avx2:
+        fillAvx2(m_state, data, groups, range, threshold, base);
+        break;
+#endif
+    default:
+        fillScalar(m_state, data, groups, range, threshold, base);
+        break;
+    }
+    data += groups * Lanes;
+    remaining -= groups * Lanes;
+
+    for (; remaining > 0; --remaining) {
+        *data++ = qint64(base + boundedLane(m_state, m_lane, range, threshold));
+        m_lane = (m_lane + 1) % Lanes;
+    }
+}
+
+void BatchFill::discard(qint64 count, quint64 range)
+{
+    qint64 scratch[1024];
+    while (count > 0) {
+        const qint64 n = std::min<qint64>(count, qint64(std::size(scratch)));
+        fill(std::span<qint64>(scratch, size_t(n)), range);
+        count -= n;
+    }
+}
+
+BatchFill::Kernel BatchFill::supportedKernel()
+{
+    static const Kernel kernel = detectKernel();
+    return kernel;
+}
+
+BatchFill::Kernel BatchFill::activeKernel()
+{
+    return activeKernelStorage().load(std::memory_order_relaxed);
+}
+
+void BatchFill::setActiveKernel(Kernel kernel)
+{
+    activeKernelStorage().store(std::min(kernel, supportedKernel()), std::memory_order_relaxed);
+}
+
+const char *BatchFill::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Avx512:
+        return "avx512";
+    case Kernel::Avx2:
+        return "avx2";
+    case Kernel::Scalar:
+        break;
+    }
+    return "scalar";
+}
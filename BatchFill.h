@@ -0,0 +1,43 @@
+// BatchFill.h
+#ifndef BATCHFILL_H
+#define BATCHFILL_H
+
+#include <QtGlobal>
+#include <span>
+
+// 批量生成 [0, range) 内的均匀整数
+// 内部是 Lanes 路独立的 xoshiro256** 流，第 i 个结果来自第 i % Lanes 路；
+// 被拒绝的值只在同一路重新抽取。因此 AVX2 / AVX-512 向量实现与标量实现的输出逐位相同，
+// 运行时按 CPU 支持情况选择最快的实现。
+class BatchFill
+{
+public:
+    static constexpr int Lanes = 8;
+
+    enum class Kernel {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    BatchFill(quint64 seed, quint64 stream);
+
+    // out[i] = offset + [0, range) 内的均匀整数(按 64 位无符号回绕相加)，range 不能为 0
+    void fill(std::span<qint64> out, quint64 range, qint64 offset = 0);
+    // 跳过接下来 count 个结果，与丢弃同样数量的 fill() 输出等价
+    void discard(qint64 count, quint64 range);
+
+    // 当前 CPU 支持的最快实现
+    static Kernel supportedKernel();
+    // 实际使用的实现，默认为 supportedKernel()；设置时不会超过 CPU 支持的级别
+    static Kernel activeKernel();
+    static void setActiveKernel(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+private:
+    // m_state[word][lane]，按字存放便于整组载入向量寄存器
+    alignas(64) quint64 m_state[4][Lanes];
+    int m_lane = 0; // 下一个结果所在的路
+};
+
+#endif // BATCHFILL_H
@@ -0,0 +1,211 @@
+// BatchGenerator.cpp
+#include "BatchGenerator.h"
+#include "NumberSerializer.h"
+#include "UniqueSampler.h"
+#include <QByteArray>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace {
+// 每次抽取不超过该数量、且可用数字至少是它的 4 倍时，不重复抽样用拒绝法
+constexpr qint64 kRejectionCount = 64;
+// 每一轮为每个线程准备的块数，写入文件时其他线程不工作，块太少时线程会空闲
+constexpr qint64 kBlocksPerThread = 4;
+// 每一轮在内存中的数字个数上限(数字和文本合计约 30 字节一个)；单次抽取超过它时每轮只处理一次抽取
+constexpr qint64 kMaxRoundNumbers = BatchGenerator::BlockSize * 256;
+
+// 生成第 draw 次抽取的结果
+using DrawFunction = std::function<void(quint64 draw, qint64 *out)>;
+
+template <RandomEngine Engine>
+void drawUniform(const ParallelGenerator::Params &params, quint64 available, quint64 draw, qint64 count, qint64 *out)
+{
+    Engine engine(params.seed, draw);
+    if (!params.unique) {
+        for (qint64 i = 0; i < count; ++i) {
+            out[i] = params.excluded.selectAvailable(params.min, boundedRandom(engine, available));
+        }
+        return;
+    }
+
+    // 可用数字远多于抽取数量，重试很少；数量很小，线性查找比哈希表快
+    quint64 ranks[kRejectionCount];
+    for (qint64 i = 0; i < count; ++i) {
+        quint64 rank;
+        do {
+            rank = boundedRandom(engine, available);
+        } while (std::find(ranks, ranks + i, rank) != ranks + i);
+        ranks[i] = rank;
+        out[i] = params.excluded.selectAvailable(params.min, rank);
+    }
+}
+
+template <RandomEngine Engine>
+void drawDistribution(const Distribution &distribution, quint64 seed, quint64 draw, qint64 count, qint64 *out)
+{
+    Engine engine(seed, draw);
+    distribution.fill(engine, std::span<qint64>(out, size_t(count)));
+}
+
+template <RandomEngine Engine>
+void drawWeighted(const WeightTable &table, quint64 seed, quint64 draw, qint64 count, qint64 *out)
+{
+    Engine engine(seed, draw);
+    for (qint64 i = 0; i < count; ++i) {
+        out[i] = table.draw(engine);
+    }
+}
+
+DrawFunction drawFunction(const BatchGenerator::Params &params, quint64 available)
+{
+    const ParallelGenerator::Params &draw = params.draw;
+    const qint64 count = params.count;
+
+    if (draw.distribution) {
+        return withEngine(draw.engine, [&draw, count](auto engineType) -> DrawFunction {
+            using Engine = typename decltype(engineType)::type;
+            return [&draw, count](quint64 d, qint64 *out) {
+                drawDistribution<Engine>(*draw.distribution, draw.seed, d, count, out);
+            };
+        });
+    }
+    if (params.weights && draw.unique) {
+        return [&params, count](quint64 d, qint64 *out) {
+            WeightTable::Sampler sampler(params.weights, true, params.draw.engine, params.draw.seed, d);
+            sampler.fill(std::span<qint64>(out, size_t(count)));
+        };
+    }
+    if (params.weights) {
+        return withEngine(draw.engine, [&params, count](auto engineType) -> DrawFunction {
+            using Engine = typename decltype(engineType)::type;
+            return [&params, count](quint64 d, qint64 *out) {
+                drawWeighted<Engine>(*params.weights, params.draw.seed, d, count, out);
+            };
+        });
+    }
+    if (!draw.unique || (count <= kRejectionCount && quint64(count) * 4 <= available)) {
+        return withEngine(draw.engine, [&draw, available, count](auto engineType) -> DrawFunction {
+            using Engine = typename decltype(engineType)::type;
+            return [&draw, available, count](quint64 d, qint64 *out) {
+                drawUniform<Engine>(draw, available, d, count, out);
+            };
+        });
+    }
+    // 每次抽取的数量较多或接近可用数量时用洗牌
+    return [&draw, count](quint64 d, qint64 *out) {
+        const QList<qint64> numbers =
+            UniqueSampler::sample(draw.min, draw.max, draw.excluded, count, draw.engine, draw.seed, {}, d);
+        std::copy(numbers.cbegin(), numbers.cend(), out);
+    };
+}
+}
+
+BatchGenerator::Result BatchGenerator::generateToFile(const QString &filePath, const Params &params,
+                                                      const ProgressCallback &progress, QString *errorString,
+                                                      int threadCount)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString) {
+            *errorString = message;
+        }
+        return Result::Failed;
+    };
+
+    const qint64 count = params.count;
+    const quint64 available = UniqueSampler::availableCount(params.draw.min, params.draw.max, params.draw.excluded);
+    if (count <= 0 || params.draws <= 0 || available == 0 || (params.draw.unique && quint64(count) > available)) {
+        return fail("请求的数量超过了可用数字的数量");
+    }
+    if (params.draws > std::numeric_limits<qint64>::max() / count) {
+        return fail("抽取的总数量过大");
+    }
+
+    const DrawFunction drawOne = drawFunction(params, available);
+
+    // 块总是从一次抽取的开头开始，单独格式化的结果与整体格式化相同
+    const qint64 drawsPerBlock = std::max<qint64>(1, BlockSize / count);
+    const qint64 blockCount = (params.draws - 1) / drawsPerBlock + 1;
+    const int threads = threadCount > 0 ? threadCount : QThread::idealThreadCount();
+    const qint64 numbersPerBlock = drawsPerBlock * count;
+    const qint64 blocksPerRound = std::min({blockCount, qint64(threads) * kBlocksPerThread,
+                                            std::max<qint64>(1, kMaxRoundNumbers / numbersPerBlock)});
+
+    // 写入临时文件，完成后再替换目标文件；取消或失败时不留下半截结果
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(file.errorString());
+    }
+
+    std::vector<QByteArray> texts(blocksPerRound);
+    std::atomic<qint64> drawsDone{0};
+    std::atomic<bool> canceled{false};
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    for (qint64 roundStart = 0; roundStart < blockCount; roundStart += blocksPerRound) {
+        const qint64 roundBlocks = std::min(blocksPerRound, blockCount - roundStart);
+        std::atomic<qint64> nextBlock{0};
+
+        auto worker = [&]() {
+            std::vector<qint64> numbers(numbersPerBlock);
+            for (qint64 b = nextBlock.fetch_add(1, std::memory_order_relaxed); b < roundBlocks;
+                 b = nextBlock.fetch_add(1, std::memory_order_relaxed)) {
+                if (canceled.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const qint64 firstDraw = (roundStart + b) * drawsPerBlock;
+                const qint64 blockDraws = std::min(drawsPerBlock, params.draws - firstDraw);
+                for (qint64 d = 0; d < blockDraws; ++d) {
+                    drawOne(quint64(firstDraw + d), numbers.data() + d * count);
+                }
+
+                const qint64 blockNumbers = blockDraws * count;
+                QByteArray &text = texts[size_t(b)];
+                text.resize(blockNumbers * NumberSerializer::MaxEntrySize);
+                NumberSerializer serializer(NumberSerializer::Layout::Csv, blockNumbers, count);
+                text.truncate(serializer.serialize(numbers.data(), blockNumbers, text.data()) - text.constData());
+
+                drawsDone.fetch_add(blockDraws, std::memory_order_relaxed);
+            }
+        };
+
+        for (qint64 t = 0; t < std::min<qint64>(threads, roundBlocks); ++t) {
+            pool.start(worker);
+        }
+        while (!pool.waitForDone(50)) {
+            if (progress && !progress(drawsDone.load(std::memory_order_relaxed), params.draws)) {
+                canceled.store(true, std::memory_order_relaxed);
+            }
+        }
+        if (canceled.load(std::memory_order_relaxed)) {
+            file.cancelWriting();
+            return Result::Canceled;
+        }
+
+        for (qint64 b = 0; b < roundBlocks; ++b) {
+            if (file.write(texts[size_t(b)]) != texts[size_t(b)].size()) {
+                const QString message = file.errorString();
+                file.cancelWriting();
+                return fail(message);
+            }
+        }
+
+        if (progress && !progress(drawsDone.load(std::memory_order_relaxed), params.draws)) {
+            file.cancelWriting();
+            return Result::Canceled;
+        }
+    }
+
+    if (!file.commit()) {
+        return fail(file.errorString());
+    }
+
+    return Result::Finished;
+}
@@ -0,0 +1,38 @@
+// BatchGenerator.h
+#ifndef BATCHGENERATOR_H
+#define BATCHGENERATOR_H
+
+#include <QString>
+#include <memory>
+#include "ParallelGenerator.h"
+#include "StreamGenerator.h"
+#include "WeightTable.h"
+
+// 批量抽取：用同一设置独立抽取 draws 次，每次 count 个，逐行写入文件(逗号分隔)
+// 第 d 次抽取只使用 (种子, d) 随机流，结果与线程数和调度顺序无关。
+// 抽取按块分给多个线程，每个线程把自己的块直接格式化为文本，主线程只按顺序写入文件；
+// 每次抽取的数量较少时，不重复抽样直接拒绝重复的序号，不为每次抽取建立洗牌表。
+// 每一轮同时在内存中的数字有上限，但一次抽取总是整体生成，调用方须限制每次抽取的数量(见 GenerationJob)。
+class BatchGenerator
+{
+public:
+    static constexpr qint64 BlockSize = 16384; // 每块大约包含的数字个数
+
+    using Result = StreamGenerator::Result;
+    // 进度以抽取次数计，返回 false 表示取消
+    using ProgressCallback = StreamGenerator::ProgressCallback;
+
+    struct Params
+    {
+        ParallelGenerator::Params draw;             // 范围、排除集合、是否重复、种子和引擎
+        std::shared_ptr<const WeightTable> weights; // 非空时按权重抽样
+        qint64 count = 0;                           // 每次抽取的数量
+        qint64 draws = 0;                           // 抽取次数
+    };
+
+    // threadCount 为 0 时使用 QThread::idealThreadCount()
+    static Result generateToFile(const QString &filePath, const Params &params, const ProgressCallback &progress,
+                                 QString *errorString = nullptr, int threadCount = 0);
+};
+
+#endif // BATCHGENERATOR_H
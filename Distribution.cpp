@@ -0,0 +1,218 @@
+// Distribution.cpp
+#include "Distribution.h"
+#include <numbers>
+
+namespace {
+// 不超过 2^63 的最大 double，比它大的值转换为 qint64 会溢出
+constexpr double kMaxConvertible = 9223372036854774784.0;
+
+// 每层面积(正态为未归一化的 exp(-x²/2))
+constexpr double kNormalArea = 0.00492867323399;
+constexpr double kExponentialArea = 0.0039496598225815571993;
+}
+
+QString Distribution::kindName(Kind kind)
+{
+    switch (kind) {
+    case Kind::Normal:
+        return "normal";
+    case Kind::Exponential:
+        return "exponential";
+    case Kind::Poisson:
+        return "poisson";
+    case Kind::Binomial:
+        return "binomial";
+    case Kind::Uniform:
+        break;
+    }
+    return "uniform";
+}
+
+Distribution::Kind Distribution::kindFromName(const QString &name)
+{
+    for (Kind kind : {Kind::Normal, Kind::Exponential, Kind::Poisson, Kind::Binomial}) {
+        if (name == kindName(kind)) {
+            return kind;
+        }
+    }
+    return Kind::Uniform;
+}
+
+QString Distribution::displayName(Kind kind)
+{
+    switch (kind) {
+    case Kind::Normal:
+        return "正态分布";
+    case Kind::Exponential:
+        return "指数分布";
+    case Kind::Poisson:
+        return "泊松分布";
+    case Kind::Binomial:
+        return "二项分布";
+    case Kind::Uniform:
+        break;
+    }
+    return "均匀分布";
+}
+
+bool Distribution::validate(const Params &params, QString *errorString)
+{
+    switch (params.kind) {
+    case Kind::Normal:
+        if (!std::isfinite(params.mean) || !std::isfinite(params.stddev) || params.stddev <= 0) {
+            *errorString = "正态分布的标准差必须大于 0";
+            return false;
+        }
+        break;
+    case Kind::Exponential:
+    case Kind::Poisson:
+        // 泊松分布的均值过大时 k·log(λ) 等项失去精度
+        if (!std::isfinite(params.mean) || params.mean <= 0 || (params.kind == Kind::Poisson && params.mean > 1e15)) {
+            *errorString = QString("%1的均值必须大于 0").arg(displayName(params.kind));
+            return false;
+        }
+        break;
+    case Kind::Binomial:
+        if (params.trials <= 0 || params.trials > (qint64(1) << 53)) {
+            *errorString = "二项分布的试验次数必须在 1 到 2^53 之间";
+            return false;
+        }
+        if (!(params.probability >= 0 && params.probability <= 1)) {
+            *errorString = "二项分布的成功概率必须在 0 到 1 之间";
+            return false;
+        }
+        break;
+    case Kind::Uniform:
+        break;
+    }
+    return true;
+}
+
+Distribution::Distribution(qint64 min, qint64 max, const ExclusionSet &excluded, const Params &params)
+    : m_min(min),
+      m_max(max),
+      m_low(double(min)),
+      m_high(std::min(double(max), kMaxConvertible)),
+      m_excluded(excluded),
+      m_params(params),
+      m_normal(&normalZiggurat()),
+      m_exponential(&exponentialZiggurat())
+{
+    if (!validate(params, &m_errorString)) {
+        return;
+    }
+
+    if (params.kind == Kind::Poisson) {
+        const double mean = params.mean;
+        m_expNegMean = std::exp(-mean);
+        m_logMean = std::log(mean);
+        m_b = 0.931 + 2.53 * std::sqrt(mean);
+        m_a = -0.059 + 0.02483 * m_b;
+        m_logInvAlpha = std::log(1.1239 + 1.1328 / (m_b - 3.4));
+        m_vr = 0.9277 - 3.6224 / (m_b - 2);
+    } else if (params.kind == Kind::Binomial) {
+        const double n = double(params.trials);
+        m_flipped = params.probability > 0.5;
+        m_p = m_flipped ? 1 - params.probability : params.probability;
+        m_r = m_p / (1 - m_p);
+        m_q0 = std::exp(n * std::log1p(-m_p));
+        if (n * m_p >= InversionLimit) {
+            const double stddev = std::sqrt(n * m_p * (1 - m_p));
+            m_b = 1.15 + 2.53 * stddev;
+            m_a = -0.0873 + 0.0248 * m_b + 0.01 * m_p;
+            m_c = n * m_p + 0.5;
+            m_vr = 0.92 - 4.2 / m_b;
+            m_alpha = (2.83 + 5.1 / m_b) * stddev;
+            m_mode = std::floor((n + 1) * m_p);
+            m_h = (m_mode + 0.5) * std::log((m_mode + 1) / (m_r * (n - m_mode + 1))) + stirlingTail(m_mode)
+                  + stirlingTail(n - m_mode);
+        }
+    }
+
+    // 试抽一批，确认范围内(且未排除)的概率不会小到使重试无法结束
+    Xoshiro256StarStar probe(0x5EED, 0);
+    int accepted = 0;
+    qint64 value;
+    for (int i = 0; i < ProbeCount; ++i) {
+        accepted += tryDraw(probe, &value) ? 1 : 0;
+    }
+    if (accepted < int(ProbeCount * MinAcceptance)) {
+        m_errorString = QString("%1落在范围 %2 - %3 内(除排除数字外)的概率太小，请调整参数或改为超出范围时取端点")
+                            .arg(displayName(params.kind))
+                            .arg(min)
+                            .arg(max);
+    }
+}
+
+const Distribution::Ziggurat &Distribution::normalZiggurat()
+{
+    // Marsaglia & Tsang：各层面积相同，最底层含尾部；横坐标取 52 位
+    static const Ziggurat table = [] {
+        Ziggurat z{};
+        const double scale = 0x1.0p52;
+        double x = NormalR;
+        double previous = x;
+        const double q = kNormalArea / std::exp(-0.5 * x * x);
+        z.k[0] = quint64((x / q) * scale);
+        z.k[1] = 0;
+        z.w[0] = q / scale;
+        z.w[Layers - 1] = x / scale;
+        z.f[0] = 1.0;
+        z.f[Layers - 1] = std::exp(-0.5 * x * x);
+        for (int i = Layers - 2; i >= 1; --i) {
+            x = std::sqrt(-2 * std::log(kNormalArea / x + std::exp(-0.5 * x * x)));
+            z.k[i + 1] = quint64((x / previous) * scale);
+            previous = x;
+            z.f[i] = std::exp(-0.5 * x * x);
+            z.w[i] = x / scale;
+        }
+        return z;
+    }();
+    return table;
+}
+
+const Distribution::Ziggurat &Distribution::exponentialZiggurat()
+{
+    // 横坐标取 53 位
+    static const Ziggurat table = [] {
+        Ziggurat z{};
+        const double scale = 0x1.0p53;
+        double x = ExponentialR;
+        double previous = x;
+        const double q = kExponentialArea / std::exp(-x);
+        z.k[0] = quint64((x / q) * scale);
+        z.k[1] = 0;
+        z.w[0] = q / scale;
+        z.w[Layers - 1] = x / scale;
+        z.f[0] = 1.0;
+        z.f[Layers - 1] = std::exp(-x);
+        for (int i = Layers - 2; i >= 1; --i) {
+            x = -std::log(kExponentialArea / x + std::exp(-x));
+            z.k[i + 1] = quint64((x / previous) * scale);
+            previous = x;
+            z.f[i] = std::exp(-x);
+            z.w[i] = x / scale;
+        }
+        return z;
+    }();
+    return table;
+}
+
+double Distribution::stirlingTail(double k)
+{
+    // log(k!) - [(k + 1/2)·log(k + 1) - (k + 1) + log(2π)/2]
+    static constexpr double small[] = {0.0810614667953272,  0.0413406959554092,  0.0276779256849983,
+                                       0.02079067210376509, 0.0166446911898211,  0.0138761288230707,
+                                       0.0118967099458917,  0.0104112652619720,  0.00925546218271273,
+                                       0.00833056343336287};
+    if (k <= 9) {
+        return small[int(k)];
+    }
+    const double square = (k + 1) * (k + 1);
+    return (1.0 / 12 - (1.0 / 360 - 1.0 / 1260 / square) / square) / (k + 1);
+}
+
+double Distribution::logFactorial(double k)
+{
+    return (k + 0.5) * std::log(k + 1) - (k + 1) + 0.5 * std::log(2 * std::numbers::pi) + stirlingTail(k);
+}
@@ -0,0 +1,312 @@
+// Distribution.h
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+#include <QString>
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+
+// 非均匀分布的整数抽样(可重复)
+// 正态和指数分布用 256 层 ziggurat：约 99% 的抽取只需一个 64 位随机数、一次查表、一次乘法和一次比较，
+// 结果四舍五入(正态)或向下取整(指数)为整数。泊松和二项分布在均值较小时按概率反演，
+// 较大时用 Hörmann 的变换拒绝法(PTRS / BTRS)，每次抽取的期望耗时与参数无关。
+// 抽到 [min, max] 以外的值时按 Bounds 重新抽取或取最近的端点；抽到排除的数字时总是重新抽取。
+// 抽样只依赖传入的引擎，由 DrawEngine 按块的随机流调用，因此多线程、流式和批量生成都可以直接使用。
+class Distribution
+{
+public:
+    enum class Kind {
+        Uniform,
+        Normal,
+        Exponential,
+        Poisson,
+        Binomial
+    };
+
+    enum class Bounds {
+        Reject, // 重新抽取，结果服从截断后的分布
+        Clamp   // 取最近的端点
+    };
+
+    struct Params
+    {
+        Kind kind = Kind::Uniform;
+        double mean = 0;          // 正态分布的均值；指数和泊松分布的均值
+        double stddev = 1;        // 正态分布的标准差
+        qint64 trials = 10;       // 二项分布的试验次数
+        double probability = 0.5; // 二项分布每次试验成功的概率
+        Bounds bounds = Bounds::Reject;
+
+        bool operator==(const Params &other) const = default;
+    };
+
+    // 建立时试抽 ProbeCount 次，落在范围内(且未排除)的比例低于 MinAcceptance 时拒绝，避免长时间重试
+    static constexpr int ProbeCount = 65536;
+    static constexpr double MinAcceptance = 1.0 / 1024;
+
+    // 设置文件和命令行中的名称
+    static QString kindName(Kind kind);
+    static Kind kindFromName(const QString &name);
+    // 界面显示的名称
+    static QString displayName(Kind kind);
+    // 检查参数本身，失败时给出原因
+    static bool validate(const Params &params, QString *errorString);
+
+    // excluded 须已裁剪到 [min, max]；建立失败时 isValid() 为 false，errorString() 给出原因
+    Distribution(qint64 min, qint64 max, const ExclusionSet &excluded, const Params &params);
+
+    bool isValid() const { return m_errorString.isEmpty(); }
+    QString errorString() const { return m_errorString; }
+    const Params &params() const { return m_params; }
+
+    template <RandomEngine Engine>
+    qint64 draw(Engine &engine) const
+    {
+        qint64 value;
+        while (!tryDraw(engine, &value)) {
+        }
+        return value;
+    }
+
+    template <RandomEngine Engine>
+    void fill(Engine &engine, std::span<qint64> out) const
+    {
+        for (qint64 &value : out) {
+            value = draw(engine);
+        }
+    }
+
+private:
+    static constexpr int Layers = 256;
+
+    struct Ziggurat
+    {
+        quint64 k[Layers]; // 整数部分小于 k[i] 时直接接受
+        double w[Layers];  // 整数部分到横坐标的比例
+        double f[Layers];  // 各层上边界的密度
+    };
+
+    static const Ziggurat &normalZiggurat();
+    static const Ziggurat &exponentialZiggurat();
+    // log(k!)，k 较大时用 Stirling 级数
+    static double logFactorial(double k);
+    static double stirlingTail(double k);
+
+    // [0, 1) 内的均匀实数，53 位精度
+    template <RandomEngine Engine>
+    static double uniform(Engine &engine)
+    {
+        return double(engine() >> 11) * 0x1.0p-53;
+    }
+
+    // 抽一次，落在范围外(Reject 时)或抽到排除的数字时返回 false
+    template <RandomEngine Engine>
+    bool tryDraw(Engine &engine, qint64 *result) const
+    {
+        double value = 0;
+        switch (m_params.kind) {
+        case Kind::Normal:
+            value = std::floor(m_params.mean + m_params.stddev * standardNormal(engine) + 0.5);
+            break;
+        case Kind::Exponential:
+            value = std::floor(m_params.mean * standardExponential(engine));
+            break;
+        case Kind::Poisson:
+            value = poisson(engine);
+            break;
+        case Kind::Binomial:
+            value = binomial(engine);
+            break;
+        case Kind::Uniform:
+            // 均匀抽样通常由 DrawEngine 直接完成，不经过这里
+            value = std::floor(m_low + uniform(engine) * (m_high - m_low + 1));
+            break;
+        }
+
+        // 先按浮点数比较，转换为整数时不会溢出
+        if (value < m_low || value > m_high) {
+            if (m_params.bounds == Bounds::Reject) {
+                return false;
+            }
+            *result = value < m_low ? m_min : m_max;
+        } else {
+            *result = std::clamp(qint64(value), m_min, m_max);
+        }
+        return m_excluded.isEmpty() || !m_excluded.contains(*result);
+    }
+
+    template <RandomEngine Engine>
+    double standardNormal(Engine &engine) const
+    {
+        const Ziggurat &z = *m_normal;
+        for (;;) {
+            // 低 8 位选层，1 位符号，高 52 位为横坐标
+            const quint64 bits = engine();
+            const int layer = int(bits & 0xff);
+            const bool negative = bits & 0x100;
+            const quint64 magnitude = bits >> 12;
+            const double x = double(magnitude) * z.w[layer];
+            if (magnitude < z.k[layer]) {
+                return negative ? -x : x;
+            }
+            if (layer == 0) {
+                // 尾部 (r, ∞)：Marsaglia 的指数拒绝法
+                for (;;) {
+                    const double tailX = -std::log1p(-uniform(engine)) / NormalR;
+                    const double tailY = -std::log1p(-uniform(engine));
+                    if (tailY + tailY > tailX * tailX) {
+                        return negative ? -(NormalR + tailX) : NormalR + tailX;
+                    }
+                }
+            }
+            if ((z.f[layer - 1] - z.f[layer]) * uniform(engine) + z.f[layer] < std::exp(-0.5 * x * x)) {
+                return negative ? -x : x;
+            }
+        }
+    }
+
+    template <RandomEngine Engine>
+    double standardExponential(Engine &engine) const
+    {
+        const Ziggurat &z = *m_exponential;
+        for (;;) {
+            // 低 8 位选层，高 53 位为横坐标
+            const quint64 bits = engine();
+            const int layer = int(bits & 0xff);
+            const quint64 magnitude = bits >> 11;
+            const double x = double(magnitude) * z.w[layer];
+            if (magnitude < z.k[layer]) {
+                return x;
+            }
+            if (layer == 0) {
+                // 指数分布无记忆，尾部就是平移后的指数分布
+                return ExponentialR - std::log1p(-uniform(engine));
+            }
+            if ((z.f[layer - 1] - z.f[layer]) * uniform(engine) + z.f[layer] < std::exp(-x)) {
+                return x;
+            }
+        }
+    }
+
+    template <RandomEngine Engine>
+    double poisson(Engine &engine) const
+    {
+        const double mean = m_params.mean;
+        if (mean < InversionLimit) {
+            // 逐项累加概率
+            double k = 0;
+            double p = m_expNegMean;
+            double sum = p;
+            const double u = uniform(engine);
+            while (u > sum && p > 0) {
+                ++k;
+                p *= mean / k;
+                sum += p;
+            }
+            return k;
+        }
+
+        // PTRS
+        for (;;) {
+            const double u = uniform(engine) - 0.5;
+            const double v = uniform(engine);
+            const double us = 0.5 - std::abs(u);
+            const double k = std::floor((2 * m_a / us + m_b) * u + mean + 0.43);
+            if (us >= 0.07 && v <= m_vr) {
+                return k;
+            }
+            if (k < 0 || (us < 0.013 && v > us)) {
+                continue;
+            }
+            if (std::log(v) + m_logInvAlpha - std::log(m_a / (us * us) + m_b)
+                <= -mean + k * m_logMean - logFactorial(k)) {
+                return k;
+            }
+        }
+    }
+
+    template <RandomEngine Engine>
+    double binomial(Engine &engine) const
+    {
+        // 按 p <= 0.5 抽取成功次数，p > 0.5 时换成失败次数
+        const double k = binomialLow(engine);
+        return m_flipped ? double(m_params.trials) - k : k;
+    }
+
+    template <RandomEngine Engine>
+    double binomialLow(Engine &engine) const
+    {
+        const double n = double(m_params.trials);
+        if (n * m_p < InversionLimit) {
+            // 逐项累加概率，P(k + 1) = P(k)·(n - k)/(k + 1)·p/(1 - p)
+            double k = 0;
+            double p = m_q0;
+            double sum = p;
+            const double u = uniform(engine);
+            while (u > sum && p > 0 && k < n) {
+                p *= (n - k) / (k + 1) * m_r;
+                ++k;
+                sum += p;
+            }
+            return k;
+        }
+
+        // BTRS
+        for (;;) {
+            const double u = uniform(engine) - 0.5;
+            const double v = uniform(engine);
+            const double us = 0.5 - std::abs(u);
+            const double k = std::floor((2 * m_a / us + m_b) * u + m_c);
+            if (us >= 0.07 && v <= m_vr) {
+                return k;
+            }
+            if (k < 0 || k > n) {
+                continue;
+            }
+            const double logV = std::log(v * m_alpha / (m_a / (us * us) + m_b));
+            const double bound = m_h + (n + 1) * std::log((n - m_mode + 1) / (n - k + 1))
+                                 + (k + 0.5) * std::log(m_r * (n - k + 1) / (k + 1)) - stirlingTail(k)
+                                 - stirlingTail(n - k);
+            if (logV <= bound) {
+                return k;
+            }
+        }
+    }
+
+    // 均值(二项分布为 np)低于该值时用反演
+    static constexpr double InversionLimit = 10;
+    static constexpr double NormalR = 3.6541528853610088;    // 正态 ziggurat 最底层的右端
+    static constexpr double ExponentialR = 7.69711747013104972; // 指数 ziggurat 最底层的右端
+
+    qint64 m_min;
+    qint64 m_max;
+    double m_low;  // m_min 的浮点值
+    double m_high; // 不超过 m_max 且转换为整数不会溢出的浮点值
+    ExclusionSet m_excluded;
+    Params m_params;
+    QString m_errorString;
+
+    const Ziggurat *m_normal;
+    const Ziggurat *m_exponential;
+
+    // 泊松和二项分布预先算好的常数
+    double m_expNegMean = 0;
+    double m_logMean = 0;
+    double m_p = 0;       // min(p, 1 - p)
+    bool m_flipped = false;
+    double m_q0 = 0;      // (1 - m_p)^n
+    double m_a = 0;
+    double m_b = 0;
+    double m_c = 0;
+    double m_vr = 0;
+    double m_alpha = 0;
+    double m_logInvAlpha = 0;
+    double m_r = 0;       // m_p / (1 - m_p)
+    double m_mode = 0;
+    double m_h = 0;       // BTRS 上界中只与 n、p 有关的部分
+};
+
+#endif // DISTRIBUTION_H
@@ -0,0 +1,92 @@
+// DrawClient.cpp
+#include "DrawClient.h"
+
+bool DrawClient::connectToServer(const QString &name, int timeout)
+{
+    m_socket.connectToServer(name);
+    if (!m_socket.waitForConnected(timeout)) {
+        m_errorString = m_socket.errorString();
+        return false;
+    }
+    return true;
+}
+
+quint32 DrawClient::send(DrawProtocol::Request request, const ExclusionSet &excluded)
+{
+    request.id = m_nextId++;
+    request.exclusionHash = excluded.hash();
+    request.intervals = excluded.intervals();
+    m_inFlight.insert(request.id, request);
+
+    if (!write(request)) {
+        return 0;
+    }
+    return request.id;
+}
+
+bool DrawClient::write(const DrawProtocol::Request &request)
+{
+    QByteArray frame;
+    if (request.exclusionHash != 0 && m_sentExclusions.contains(request.exclusionHash)) {
+        DrawProtocol::Request byHash = request;
+        byHash.intervals.clear();
+        DrawProtocol::appendRequest(&frame, byHash);
+    } else {
+        DrawProtocol::appendRequest(&frame, request);
+        if (request.exclusionHash != 0) {
+            m_sentExclusions.insert(request.exclusionHash);
+        }
+    }
+
+    if (m_socket.write(frame) != frame.size()) {
+        m_errorString = m_socket.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool DrawClient::receive(DrawProtocol::Response *response, int timeout)
+{
+    for (;;) {
+        const DrawProtocol::FrameResult result = DrawProtocol::takeResponse(m_buffer, &m_offset, response);
+        if (result == DrawProtocol::FrameResult::Malformed) {
+            m_errorString = "应答格式错误";
+            return false;
+        }
+
+        if (result == DrawProtocol::FrameResult::Complete) {
+            // 已读完的部分较多时再整体移走，避免每帧都移动缓冲区
+            if (m_offset > m_buffer.size() / 2) {
+                m_buffer.remove(0, m_offset);
+                m_offset = 0;
+            }
+
+            auto request = m_inFlight.find(response->id);
+            if (response->status == DrawProtocol::Status::UnknownExclusion && request != m_inFlight.end()) {
+                // 服务端缓存已清除，带区间重发并继续等待
+                m_sentExclusions.remove(request->exclusionHash);
+                if (!write(*request)) {
+                    return false;
+                }
+                continue;
+            }
+            if (request != m_inFlight.end()) {
+                m_inFlight.erase(request);
+            }
+            return true;
+        }
+
+        m_socket.flush();
+        if (m_socket.bytesAvailable() == 0 && !m_socket.waitForReadyRead(timeout)) {
+            m_errorString = m_socket.errorString();
+            return false;
+        }
+        m_buffer.append(m_socket.readAll());
+    }
+}
+
+bool DrawClient::draw(const DrawProtocol::Request &request, const ExclusionSet &excluded,
+                      DrawProtocol::Response *response, int timeout)
+{
+    return send(request, excluded) != 0 && receive(response, timeout);
+}
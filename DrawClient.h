@@ -0,0 +1,41 @@
+// DrawClient.h
+#ifndef DRAWCLIENT_H
+#define DRAWCLIENT_H
+
+#include <QHash>
+#include <QLocalSocket>
+#include <QSet>
+#include "DrawProtocol.h"
+
+// 本地抽取服务的阻塞式客户端，在创建它的线程中使用
+// send() 可以连续调用多次再用 receive() 依次取回应答(流水线)。
+// 排除集合在同一连接上只完整发送一次，之后只发送哈希；服务端缓存已清除时自动带区间重发。
+class DrawClient
+{
+public:
+    DrawClient() = default;
+
+    bool connectToServer(const QString &name = DrawProtocol::defaultServerName(), int timeout = 3000);
+    QString errorString() const { return m_errorString; }
+
+    // 发送一个请求，返回分配的编号；excluded 为空时不排除
+    quint32 send(DrawProtocol::Request request, const ExclusionSet &excluded = ExclusionSet());
+    // 取回下一个应答；重发过的请求的应答可能晚于后发的请求，按编号对应
+    bool receive(DrawProtocol::Response *response, int timeout = 30000);
+    // 发送并等待应答
+    bool draw(const DrawProtocol::Request &request, const ExclusionSet &excluded, DrawProtocol::Response *response,
+              int timeout = 30000);
+
+private:
+    bool write(const DrawProtocol::Request &request);
+
+    QLocalSocket m_socket;
+    QByteArray m_buffer;
+    qsizetype m_offset = 0;
+    quint32 m_nextId = 1;
+    QSet<quint64> m_sentExclusions;
+    QHash<quint32, DrawProtocol::Request> m_inFlight; // 带完整区间，供服务端缓存缺失时重发
+    QString m_errorString;
+};
+
+#endif // DRAWCLIENT_H
@@ -0,0 +1,139 @@
+// DrawEngine.cpp
+#include "DrawEngine.h"
+#include "UniqueSampler.h"
+#include <algorithm>
+
+DrawEngine::DrawEngine(qint64 min, qint64 max, const ExclusionSet &excluded, EngineType engine, quint64 seed,
+                       std::shared_ptr<const Distribution> distribution)
+    : m_batch(seed, 0)
+{
+    ExclusionSet clipped = excluded.clipped(min, max);
+    const quint64 available = UniqueSampler::availableCount(min, max, clipped);
+    m_config = std::make_shared<const Config>(
+        Config{min, available, std::move(clipped), engine, seed, RankPermutation(available, seed),
+               std::move(distribution)});
+    Q_ASSERT(available > 0);
+}
+
+void DrawEngine::seek(qint64 position)
+{
+    m_position = position;
+    m_block = -1;
+}
+
+void DrawEngine::startBlock(qint64 block)
+{
+    const Config &config = *m_config;
+    m_block = block;
+    switch (config.engine) {
+    case EngineType::Xoshiro256StarStar:
+        if (config.distribution) {
+            m_engine.emplace<Xoshiro256StarStar>(config.seed, quint64(block));
+        } else {
+            m_batch = BatchFill(config.seed, quint64(block));
+        }
+        break;
+    case EngineType::Pcg64:
+        m_engine.emplace<Pcg64>(config.seed, quint64(block));
+        break;
+    case EngineType::Mt19937_64:
+        m_engine.emplace<Mt19937_64>(config.seed, quint64(block));
+        break;
+    case EngineType::ChaCha20:
+        m_engine.emplace<ChaCha20>(config.seed, quint64(block));
+        break;
+    }
+}
+
+void DrawEngine::discard(qint64 count)
+{
+    if (const Distribution *distribution = m_config->distribution.get()) {
+        // 每个结果消耗的随机数个数不固定，只能逐个抽取后丢弃
+        std::visit([&](auto &engine) {
+            if constexpr (RandomEngine<std::decay_t<decltype(engine)>>) {
+                for (qint64 i = 0; i < count; ++i) {
+                    distribution->draw(engine);
+                }
+            }
+        }, m_engine);
+        return;
+    }
+    if (m_config->engine == EngineType::Xoshiro256StarStar) {
+        m_batch.discard(count, m_config->available);
+        return;
+    }
+    std::visit([&](auto &engine) {
+        if constexpr (RandomEngine<std::decay_t<decltype(engine)>>) {
+            for (qint64 i = 0; i < count; ++i) {
+                boundedRandom(engine, m_config->available);
+            }
+        }
+    }, m_engine);
+}
+
+void DrawEngine::fill(std::span<qint64> out)
+{
+    while (!out.empty()) {
+        // 随机流按块划分，起点不在块首时先消耗掉块内前面的部分
+        const qint64 block = m_position / BlockSize;
+        if (block != m_block) {
+            startBlock(block);
+            discard(m_position - block * BlockSize);
+        }
+
+        const size_t count = size_t(std::min<qint64>(qint64(out.size()), (block + 1) * BlockSize - m_position));
+        fillBlock(out.first(count));
+        out = out.subspan(count);
+        m_position += qint64(count);
+    }
+}
+
+void DrawEngine::fillBlock(std::span<qint64> out)
+{
+    const Config &config = *m_config;
+
+    if (config.distribution) {
+        std::visit([&](auto &engine) {
+            if constexpr (RandomEngine<std::decay_t<decltype(engine)>>) {
+                config.distribution->fill(engine, out);
+            }
+        }, m_engine);
+        return;
+    }
+
+    if (config.engine == EngineType::Xoshiro256StarStar) {
+        // 多路交错，可用时使用 SIMD
+        if (config.excluded.isEmpty()) {
+            m_batch.fill(out, config.available, config.min);
+            return;
+        }
+        m_batch.fill(out, config.available);
+        for (qint64 &value : out) {
+            value = config.excluded.selectAvailable(config.min, quint64(value));
+        }
+        return;
+    }
+
+    std::visit([&](auto &engine) {
+        if constexpr (RandomEngine<std::decay_t<decltype(engine)>>) {
+            for (qint64 &value : out) {
+                value = config.excluded.selectAvailable(config.min, boundedRandom(engine, config.available));
+            }
+        }
+    }, m_engine);
+}
+
+qsizetype DrawEngine::sampleUnique(std::span<qint64> out)
+{
+    const Config &config = *m_config;
+    Q_ASSERT(!config.distribution);
+    if (quint64(m_position) >= config.available) {
+        return 0;
+    }
+    const qsizetype count = qsizetype(std::min<quint64>(out.size(), config.available - quint64(m_position)));
+    for (qsizetype i = 0; i < count; ++i) {
+        out[size_t(i)] = config.excluded.selectAvailable(config.min, config.permutation(quint64(m_position + i)));
+    }
+    m_position += count;
+    return count;
+}
@@ -0,0 +1,71 @@
+// DrawEngine.h
+#ifndef DRAWENGINE_H
+#define DRAWENGINE_H
+
+#include <memory>
+#include <span>
+#include <variant>
+#include "BatchFill.h"
+#include "Distribution.h"
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+#include "RankPermutation.h"
+
+// 可嵌入的抽取引擎，不依赖界面
+// 构造时给出范围、排除集合、引擎和种子(只在这里分配内存)，之后反复调用 fill() / sampleUnique()，
+// 每次调用都不分配内存。结果按位置编号，第 i 个结果只由配置和 i 决定：
+// 可重复抽样时第 i 个结果来自第 i / BlockSize 块的 (seed, 块号) 随机流(xoshiro256** 走 BatchFill)，
+// 不重复抽样时为 RankPermutation(i) 对应的可用数字。
+// 给出非均匀分布时只能可重复抽样，每块的随机流交给 Distribution 抽取。
+// 复制只共享配置(引用计数)，因此可以为每个线程复制一份并 seek() 到各自的位置，结果与单线程相同。
+class DrawEngine
+{
+public:
+    static constexpr qint64 BlockSize = 65536;
+
+    // 可用数字的个数(max - min + 1 - 排除个数)必须大于 0 且小于 2^64；
+    // distribution 须按同样的范围和排除集合建立，为空时均匀抽样
+    DrawEngine(qint64 min, qint64 max, const ExclusionSet &excluded = ExclusionSet(),
+               EngineType engine = EngineType::Xoshiro256StarStar, quint64 seed = 0,
+               std::shared_ptr<const Distribution> distribution = nullptr);
+
+    qint64 min() const { return m_config->min; }
+    quint64 available() const { return m_config->available; }
+    const ExclusionSet &excluded() const { return m_config->excluded; }
+
+    // 下一个结果的位置
+    qint64 position() const { return m_position; }
+    void seek(qint64 position);
+
+    // 可重复抽样，依次写满 out
+    void fill(std::span<qint64> out);
+    // 不重复抽样(只用于均匀分布)：同一配置下所有位置的结果互不相同；可用数字取完后停止，返回写入的个数
+    qsizetype sampleUnique(std::span<qint64> out);
+
+private:
+    struct Config
+    {
+        qint64 min;
+        quint64 available;
+        ExclusionSet excluded; // 已裁剪到 [min, max]
+        EngineType engine;
+        quint64 seed;
+        RankPermutation permutation;
+        std::shared_ptr<const Distribution> distribution;
+    };
+
+    // 当前块的随机流；均匀抽样时 xoshiro256** 使用 m_batch
+    using BlockEngine = std::variant<std::monostate, Xoshiro256StarStar, Pcg64, Mt19937_64, ChaCha20>;
+
+    void startBlock(qint64 block);
+    void discard(qint64 count);
+    void fillBlock(std::span<qint64> out);
+
+    std::shared_ptr<const Config> m_config;
+    qint64 m_position = 0;
+    qint64 m_block = -1; // 当前随机流所属的块，-1 表示尚未建立
+    BatchFill m_batch;
+    BlockEngine m_engine;
+};
+
+#endif // DRAWENGINE_H
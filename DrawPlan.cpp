@@ -0,0 +1,48 @@
+// DrawPlan.cpp
+#include "DrawPlan.h"
+#include "UniqueSampler.h"
+
+DrawPlan::DrawPlan(qint64 min, qint64 max, qint64 count, bool unique, const ExclusionSet &excluded,
+                   const WeightTable::Weights *weights, const Distribution::Params &distribution)
+    : m_min(min), m_max(max), m_count(count), m_unique(unique), m_excluded(excluded.clipped(min, max))
+{
+    if (!GenerationJob::validate(min, max, count, unique, m_excluded, &m_errorString)) {
+        return;
+    }
+    m_available = UniqueSampler::availableCount(min, max, m_excluded);
+
+    if (weights) {
+        m_weights = std::make_shared<const WeightTable>(min, max, m_excluded, *weights);
+        if (!GenerationJob::validate(*m_weights, count, unique, &m_errorString)) {
+            return;
+        }
+    }
+
+    if (distribution.kind != Distribution::Kind::Uniform) {
+        // 非均匀分布的结果会集中在少数数字上，只支持可重复抽样
+        if (weights) {
+            m_errorString = "按权重抽样时不能再选择非均匀分布";
+            return;
+        }
+        if (unique) {
+            m_errorString = QString("%1只能在允许重复时使用").arg(Distribution::displayName(distribution.kind));
+            return;
+        }
+        auto compiled = std::make_shared<const Distribution>(min, max, m_excluded, distribution);
+        if (!compiled->isValid()) {
+            m_errorString = compiled->errorString();
+            return;
+        }
+        m_distribution = std::move(compiled);
+    }
+}
+
+GenerationJob::Request DrawPlan::request(quint64 seed, EngineType engine, bool seeded, const QString &outputPath,
+                                         NumberSerializer::Layout layout) const
+{
+    GenerationJob::Request request{m_min, m_max, m_count, m_excluded, outputPath, m_unique, seed, engine, seeded,
+                                   false, layout};
+    request.weights = m_weights;
+    request.distribution = m_distribution;
+    return request;
+}
@@ -0,0 +1,51 @@
+// DrawPlan.h
+#ifndef DRAWPLAN_H
+#define DRAWPLAN_H
+
+#include <memory>
+#include "Distribution.h"
+#include "GenerationJob.h"
+#include "WeightTable.h"
+
+// 由一组设置预先编译的抽取计划
+// 排除集合裁剪到范围并建好秩/选择索引(序号到数值的映射)，可用数量、参数检查、权重别名表和分布常数也一并算好。
+// 设置不变时反复使用同一个计划，每次生成只需按种子生成请求：集合和权重表只增加引用计数，
+// 不再复制、裁剪或重新检查。
+class DrawPlan
+{
+public:
+    // excluded 为空表示不排除，不要求已裁剪；weights 为空且 distribution 为均匀分布时均匀抽样
+    DrawPlan(qint64 min, qint64 max, qint64 count, bool unique, const ExclusionSet &excluded,
+             const WeightTable::Weights *weights = nullptr,
+             const Distribution::Params &distribution = Distribution::Params());
+    // 无法建立计划时(如权重文本无法解析)只保存原因
+    explicit DrawPlan(const QString &errorString) : m_errorString(errorString) {}
+
+    bool isValid() const { return m_errorString.isEmpty(); }
+    QString errorString() const { return m_errorString; }
+
+    qint64 min() const { return m_min; }
+    qint64 max() const { return m_max; }
+    qint64 count() const { return m_count; }
+    bool isUnique() const { return m_unique; }
+    const ExclusionSet &excluded() const { return m_excluded; }
+    quint64 available() const { return m_available; }
+    const std::shared_ptr<const WeightTable> &weights() const { return m_weights; }
+    const std::shared_ptr<const Distribution> &distribution() const { return m_distribution; }
+
+    GenerationJob::Request request(quint64 seed, EngineType engine, bool seeded, const QString &outputPath = QString(),
+                                   NumberSerializer::Layout layout = NumberSerializer::Layout::Grouped) const;
+
+private:
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+    qint64 m_count = 0;
+    bool m_unique = true;
+    ExclusionSet m_excluded; // 已裁剪到 [min, max]
+    quint64 m_available = 0;
+    std::shared_ptr<const WeightTable> m_weights;
+    std::shared_ptr<const Distribution> m_distribution;
+    QString m_errorString;
+};
+
+#endif // DRAWPLAN_H
@@ -0,0 +1,137 @@
+// DrawProtocol.cpp
+#include "DrawProtocol.h"
+#include <bit>
+#include <cstring>
+
+static_assert(std::endian::native == std::endian::little, "帧按小端序直接读写头部");
+
+QString DrawProtocol::defaultServerName()
+{
+    return "rand-full";
+}
+
+void DrawProtocol::appendRequest(QByteArray *out, const Request &request)
+{
+    static_assert(sizeof(RequestHeader) == 56, "头部布局是协议的一部分");
+    static_assert(sizeof(ExclusionSet::Interval) == 16, "区间按 (first, last) 直接写入");
+
+    RequestHeader header{};
+    header.id = request.id;
+    header.intervalCount = quint32(request.intervals.size());
+    header.min = request.min;
+    header.max = request.max;
+    header.count = request.count;
+    header.seed = request.seed;
+    header.exclusionHash = request.exclusionHash;
+    header.flags = quint8((request.unique ? UniqueFlag : 0) | (request.seeded ? SeededFlag : 0));
+    header.engine = quint8(request.engine);
+
+    const qsizetype intervalsSize = request.intervals.size() * qsizetype(sizeof(ExclusionSet::Interval));
+    const quint32 size = quint32(sizeof(header) + intervalsSize);
+    out->append(reinterpret_cast<const char *>(&size), sizeof(size));
+    out->append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out->append(reinterpret_cast<const char *>(request.intervals.constData()), intervalsSize);
+}
+
+void DrawProtocol::appendResponse(QByteArray *out, const Response &response)
+{
+    static_assert(sizeof(ResponseHeader) == 24, "头部布局是协议的一部分");
+
+    const QByteArray error = response.status == Status::Ok ? QByteArray() : response.errorString.toUtf8();
+    const ResponseHeader header{response.id, quint32(response.status), response.seed,
+                                response.status == Status::Ok ? qint64(response.numbers.size()) : 0};
+
+    const qsizetype numbersSize = header.count * qsizetype(sizeof(qint64));
+    const quint32 size = quint32(sizeof(header) + numbersSize + error.size());
+    out->append(reinterpret_cast<const char *>(&size), sizeof(size));
+    out->append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out->append(reinterpret_cast<const char *>(response.numbers.constData()), numbersSize);
+    out->append(error);
+}
+
+DrawProtocol::FrameResult DrawProtocol::frame(const QByteArray &buffer, qsizetype offset, const char **payload,
+                                              quint32 *size)
+{
+    if (buffer.size() - offset < qsizetype(sizeof(quint32))) {
+        return FrameResult::Incomplete;
+    }
+    std::memcpy(size, buffer.constData() + offset, sizeof(quint32));
+    if (*size > MaxFrameSize) {
+        return FrameResult::Malformed;
+    }
+    if (buffer.size() - offset - qsizetype(sizeof(quint32)) < qsizetype(*size)) {
+        return FrameResult::Incomplete;
+    }
+    *payload = buffer.constData() + offset + sizeof(quint32);
+    return FrameResult::Complete;
+}
+
+DrawProtocol::FrameResult DrawProtocol::takeRequest(const QByteArray &buffer, qsizetype *offset, Request *request)
+{
+    const char *payload;
+    quint32 size;
+    const FrameResult result = frame(buffer, *offset, &payload, &size);
+    if (result != FrameResult::Complete) {
+        return result;
+    }
+
+    RequestHeader header;
+    if (size < sizeof(header)) {
+        return FrameResult::Malformed;
+    }
+    std::memcpy(&header, payload, sizeof(header));
+    if (size - sizeof(header) != quint64(header.intervalCount) * sizeof(ExclusionSet::Interval)
+        || header.engine > quint8(EngineType::ChaCha20)) {
+        return FrameResult::Malformed;
+    }
+
+    request->id = header.id;
+    request->min = header.min;
+    request->max = header.max;
+    request->count = header.count;
+    request->seed = header.seed;
+    request->unique = header.flags & UniqueFlag;
+    request->seeded = header.flags & SeededFlag;
+    request->engine = EngineType(header.engine);
+    request->exclusionHash = header.exclusionHash;
+    request->intervals.resize(header.intervalCount);
+    if (header.intervalCount > 0) {
+        std::memcpy(request->intervals.data(), payload + sizeof(header), size - sizeof(header));
+    }
+
+    *offset += qsizetype(sizeof(quint32) + size);
+    return FrameResult::Complete;
+}
+
+DrawProtocol::FrameResult DrawProtocol::takeResponse(const QByteArray &buffer, qsizetype *offset, Response *response)
+{
+    const char *payload;
+    quint32 size;
+    const FrameResult result = frame(buffer, *offset, &payload, &size);
+    if (result != FrameResult::Complete) {
+        return result;
+    }
+
+    ResponseHeader header;
+    if (size < sizeof(header)) {
+        return FrameResult::Malformed;
+    }
+    std::memcpy(&header, payload, sizeof(header));
+    const quint64 numbersSize = quint64(header.count) * sizeof(qint64);
+    if (header.count < 0 || numbersSize > size - sizeof(header)) {
+        return FrameResult::Malformed;
+    }
+
+    response->id = header.id;
+    response->status = Status(header.status);
+    response->seed = header.seed;
+    response->numbers.resize(header.count);
+    if (header.count > 0) {
+        std::memcpy(response->numbers.data(), payload + sizeof(header), numbersSize);
+    }
+    response->errorString = QString::fromUtf8(payload + sizeof(header) + numbersSize,
+                                              qsizetype(size - sizeof(header) - numbersSize));
+
+    *offset += qsizetype(sizeof(quint32) + size);
+    return FrameResult::Complete;
+}
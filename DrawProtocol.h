@@ -0,0 +1,97 @@
+// DrawProtocol.h
+#ifndef DRAWPROTOCOL_H
+#define DRAWPROTOCOL_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+
+// 本地抽取服务的二进制帧格式(小端序)
+// 每帧以 4 字节长度开头(不含长度本身)，随后是定长头部和变长部分：
+// 请求头部 56 字节：编号、范围、数量、种子、排除集合哈希、区间数、标志、引擎，后接 区间数 × (first, last)；
+// 应答头部 24 字节：编号、状态、实际使用的种子、数字个数，后接 个数 × int64 或 UTF-8 错误信息。
+// 客户端可以连续发送多个请求而不等待应答，应答按请求到达的顺序返回并带有请求编号。
+// 排除集合发送过一次后，后续请求可以只带哈希，服务端从缓存取出；缓存中没有时返回 UnknownExclusion。
+class DrawProtocol
+{
+public:
+    enum class Status : quint32 {
+        Ok = 0,
+        InvalidRequest = 1,  // 参数无法完成抽样，负载为错误信息
+        UnknownExclusion = 2 // 只带哈希的排除集合不在服务端缓存中，需要带区间重新发送
+    };
+
+    enum class FrameResult {
+        Complete,
+        Incomplete, // 数据不足一帧，等待更多数据
+        Malformed   // 长度或内容非法，应断开连接
+    };
+
+    struct Request
+    {
+        quint32 id = 0;
+        qint64 min = 0;
+        qint64 max = 0;
+        qint64 count = 0;
+        quint64 seed = 0;
+        bool unique = true;
+        bool seeded = false; // false 时由服务端选择种子
+        EngineType engine = EngineType::Xoshiro256StarStar;
+        quint64 exclusionHash = 0;              // 排除集合的 ExclusionSet::hash()，没有排除时为 0
+        QList<ExclusionSet::Interval> intervals; // 为空而哈希不为 0 时引用服务端缓存
+    };
+
+    struct Response
+    {
+        quint32 id = 0;
+        Status status = Status::Ok;
+        quint64 seed = 0;
+        QList<qint64> numbers;
+        QString errorString;
+    };
+
+    static constexpr quint32 MaxFrameSize = 256 * 1024 * 1024;
+
+    static QString defaultServerName();
+
+    static void appendRequest(QByteArray *out, const Request &request);
+    static void appendResponse(QByteArray *out, const Response &response);
+
+    // 从 buffer 的 *offset 处解析一帧，成功时把 *offset 移到帧末尾
+    static FrameResult takeRequest(const QByteArray &buffer, qsizetype *offset, Request *request);
+    static FrameResult takeResponse(const QByteArray &buffer, qsizetype *offset, Response *response);
+
+private:
+    // 按自然对齐排列，没有填充
+    struct RequestHeader
+    {
+        quint32 id;
+        quint32 intervalCount;
+        qint64 min;
+        qint64 max;
+        qint64 count;
+        quint64 seed;
+        quint64 exclusionHash;
+        quint8 flags;
+        quint8 engine;
+        quint8 reserved[6];
+    };
+
+    struct ResponseHeader
+    {
+        quint32 id;
+        quint32 status;
+        quint64 seed;
+        qint64 count;
+    };
+
+    static constexpr quint8 UniqueFlag = 0x01;
+    static constexpr quint8 SeededFlag = 0x02;
+
+    // 取出帧的负载范围，返回 Complete 时 *payload 指向长度字段之后
+    static FrameResult frame(const QByteArray &buffer, qsizetype offset, const char **payload, quint32 *size);
+};
+
+#endif // DRAWPROTOCOL_H
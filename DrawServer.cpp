@@ -0,0 +1,187 @@
+// DrawServer.cpp
+#include "DrawServer.h"
+#include <QRandomGenerator>
+#include "GenerationJob.h"
+
+DrawServer::DrawServer(HistoryWriter *historyWriter, QObject *parent)
+    : QObject(parent), m_server(new QLocalServer(this)), m_historyWriter(historyWriter)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &DrawServer::acceptConnections);
+}
+
+DrawServer::~DrawServer()
+{
+    // 等待正在处理的批次，之后排队的应答不再发送
+    m_pool.waitForDone();
+}
+
+bool DrawServer::listen(const QString &name, QString *errorString)
+{
+    // 上次异常退出时留下的套接字文件会导致监听失败
+    QLocalServer::removeServer(name);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(name)) {
+        if (errorString) {
+            *errorString = m_server->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void DrawServer::acceptConnections()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        auto connection = std::make_shared<Connection>();
+        connection->socket = socket;
+        // 限制 Qt 内部的读缓冲，不读取时由操作系统的套接字缓冲对客户端形成背压
+        socket->setReadBufferSize(MaxBatchBytes);
+        m_connections.insert(socket, connection);
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, connection]() { readRequests(connection); });
+        connect(socket, &QLocalSocket::bytesWritten, this, [this, connection]() { readRequests(connection); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            m_connections.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void DrawServer::readRequests(const std::shared_ptr<Connection> &connection)
+{
+    QLocalSocket *socket = connection->socket;
+    if (!socket) {
+        return;
+    }
+    // 已有一整批在等待时不再读取，请求留在套接字中，客户端随之放慢发送；写出应答后继续读取
+    if (connection->pending.size() >= MaxBatchSize) {
+        dispatch(connection);
+        return;
+    }
+    connection->buffer.append(socket->readAll());
+
+    // 取出全部完整的帧，剩余部分留到下次
+    qsizetype offset = 0;
+    DrawProtocol::Request request;
+    DrawProtocol::FrameResult result;
+    while ((result = DrawProtocol::takeRequest(connection->buffer, &offset, &request))
+           == DrawProtocol::FrameResult::Complete) {
+        connection->pending.append(std::move(request));
+        request = DrawProtocol::Request();
+    }
+    if (result == DrawProtocol::FrameResult::Malformed) {
+        socket->disconnectFromServer();
+        return;
+    }
+    connection->buffer.remove(0, offset);
+
+    dispatch(connection);
+}
+
+void DrawServer::dispatch(const std::shared_ptr<Connection> &connection)
+{
+    if (connection->busy || connection->pending.isEmpty() || !connection->socket
+        || connection->socket->bytesToWrite() > MaxPendingWrite) {
+        return;
+    }
+
+    QList<DrawProtocol::Request> batch = connection->pending.mid(0, MaxBatchSize);
+    connection->pending.remove(0, batch.size());
+    connection->busy = true;
+
+    m_pool.start([this, connection, batch = std::move(batch)]() {
+        // 应答达到 MaxBatchBytes 后停止，剩余的请求放回队列
+        QByteArray out;
+        qsizetype handled = 0;
+        while (handled < batch.size() && out.size() < MaxBatchBytes) {
+            DrawProtocol::appendResponse(&out, handle(batch[handled]));
+            ++handled;
+        }
+
+        // 回到服务所在线程写出应答，再处理剩余和这段时间到达的请求
+        QMetaObject::invokeMethod(this, [this, connection, out = std::move(out), rest = batch.mid(handled)]() {
+            connection->busy = false;
+            if (!rest.isEmpty()) {
+                connection->pending = rest + connection->pending;
+            }
+            if (connection->socket) {
+                connection->socket->write(out);
+                dispatch(connection);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+DrawProtocol::Response DrawServer::handle(const DrawProtocol::Request &request)
+{
+    DrawProtocol::Response response;
+    response.id = request.id;
+    response.seed = request.seeded ? request.seed : QRandomGenerator::global()->generate64();
+
+    ExclusionSet excluded;
+    QString errorString;
+    if (!lookupExclusion(request, &excluded, &errorString)) {
+        response.status = errorString.isEmpty() ? DrawProtocol::Status::UnknownExclusion
+                                                : DrawProtocol::Status::InvalidRequest;
+        response.errorString = errorString;
+        return response;
+    }
+
+    if (request.count <= 0 || request.count > GenerationJob::MaxInMemoryCount) {
+        errorString = QString("数量必须在 1 到 %1 之间").arg(GenerationJob::MaxInMemoryCount);
+    }
+    if (!errorString.isEmpty()
+        || !GenerationJob::validate(request.min, request.max, request.count, request.unique, excluded, &errorString)) {
+        response.status = DrawProtocol::Status::InvalidRequest;
+        response.errorString = errorString;
+        return response;
+    }
+
+    GenerationJob job({request.min, request.max, request.count, std::move(excluded), QString(), request.unique,
+                       response.seed, request.engine, request.seeded},
+                      m_historyWriter);
+    job.run();
+    response.numbers = job.takeNumbers();
+    return response;
+}
+
+bool DrawServer::lookupExclusion(const DrawProtocol::Request &request, ExclusionSet *excluded, QString *errorString)
+{
+    if (request.exclusionHash == 0 && request.intervals.isEmpty()) {
+        return true;
+    }
+
+    QMutexLocker locker(&m_cacheMutex);
+    const ClipKey key{request.exclusionHash, request.min, request.max};
+    if (request.intervals.isEmpty()) {
+        // 只带哈希：优先使用已裁剪的结果
+        auto clipped = m_clipped.constFind(key);
+        if (clipped != m_clipped.constEnd()) {
+            *excluded = *clipped;
+            return true;
+        }
+        auto set = m_exclusions.constFind(request.exclusionHash);
+        if (set == m_exclusions.constEnd()) {
+            return false;
+        }
+        *excluded = set->clipped(request.min, request.max);
+    } else {
+        ExclusionSet set = ExclusionSet::fromIntervals(request.intervals);
+        if (set.hash() != request.exclusionHash) {
+            *errorString = "排除集合与哈希不符";
+            return false;
+        }
+        *excluded = set.clipped(request.min, request.max);
+        if (m_exclusions.size() >= MaxCachedExclusions) {
+            m_exclusions.clear();
+            m_clipped.clear();
+        }
+        m_exclusions.insert(request.exclusionHash, std::move(set));
+    }
+
+    if (m_clipped.size() >= MaxCachedExclusions * 4) {
+        m_clipped.clear();
+    }
+    m_clipped.insert(key, *excluded);
+    return true;
+}
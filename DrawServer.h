@@ -0,0 +1,75 @@
+// DrawServer.h
+#ifndef DRAWSERVER_H
+#define DRAWSERVER_H
+
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QPointer>
+#include <QThreadPool>
+#include <memory>
+#include "DrawProtocol.h"
+#include "HistoryWriter.h"
+
+// 常驻的本地抽取服务
+// 每个连接上已到达的请求按批交给线程池处理，同一连接的批次依次执行，应答保持请求顺序；
+// 不同连接并行处理。一批的应答达到 MaxBatchBytes 后剩余请求留到下一批；客户端读得慢、套接字中待写出的
+// 数据超过 MaxPendingWrite 时暂停处理该连接，待处理的请求已满一批时也不再读取，写出一部分后继续，
+// 服务的内存占用不随积压的请求和应答增长。
+// 排除集合按哈希缓存，裁剪到某个范围的结果也一并缓存，重复请求不再重建索引。
+class DrawServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxBatchSize = 256;     // 一批最多处理的请求数
+    static constexpr qint64 MaxBatchBytes = 16 * 1024 * 1024;   // 一批应答的总字节数上限
+    static constexpr qint64 MaxPendingWrite = 64 * 1024 * 1024; // 待写出的字节数超过该值时暂停处理该连接
+    static constexpr int MaxCachedExclusions = 64; // 超过后清空排除集合缓存
+
+    // historyWriter 为空时不保存历史记录
+    explicit DrawServer(HistoryWriter *historyWriter, QObject *parent = nullptr);
+    ~DrawServer();
+
+    bool listen(const QString &name = DrawProtocol::defaultServerName(), QString *errorString = nullptr);
+
+private slots:
+    void acceptConnections();
+
+private:
+    struct Connection
+    {
+        QPointer<QLocalSocket> socket;
+        QByteArray buffer;
+        QList<DrawProtocol::Request> pending;
+        bool busy = false;
+    };
+
+    struct ClipKey
+    {
+        quint64 hash;
+        qint64 min;
+        qint64 max;
+
+        bool operator==(const ClipKey &other) const = default;
+        friend size_t qHash(const ClipKey &key, size_t seed = 0) { return qHashMulti(seed, key.hash, key.min, key.max); }
+    };
+
+    void readRequests(const std::shared_ptr<Connection> &connection);
+    void dispatch(const std::shared_ptr<Connection> &connection);
+    // 在线程池中执行
+    DrawProtocol::Response handle(const DrawProtocol::Request &request);
+    bool lookupExclusion(const DrawProtocol::Request &request, ExclusionSet *excluded, QString *errorString);
+
+    QLocalServer *m_server;
+    HistoryWriter *m_historyWriter;
+    QThreadPool m_pool;
+    QHash<QLocalSocket *, std::shared_ptr<Connection>> m_connections;
+
+    QMutex m_cacheMutex;
+    QHash<quint64, ExclusionSet> m_exclusions;
+    QHash<ClipKey, ExclusionSet> m_clipped;
+};
+
+#endif // DRAWSERVER_H
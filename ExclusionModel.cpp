@@ -0,0 +1,174 @@
+// ExclusionModel.cpp
+#include "ExclusionModel.h"
+#include <algorithm>
+#include <utility>
+
+ExclusionModel::ExclusionModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ExclusionModel::setRange(qint64 min, qint64 max)
+{
+    if (min == m_min && max == m_max) {
+        return;
+    }
+
+    // 重置只改变行数，不随范围大小产生额外开销
+    beginResetModel();
+    m_min = min;
+    m_max = max;
+    endResetModel();
+}
+
+void ExclusionModel::setExcludedNumbers(const ExclusionSet &excludedNumbers)
+{
+    if (excludedNumbers == m_excluded) {
+        return;
+    }
+
+    const ExclusionSet previous = std::exchange(m_excluded, excludedNumbers);
+    if (rowCount() > 0) {
+        emitChangedRows(previous);
+    }
+}
+
+qint64 ExclusionModel::lastShownValue() const
+{
+    const quint64 span = std::min<quint64>(quint64(m_max) - quint64(m_min), quint64(MaxRows) * ColumnCount - 1);
+    return qint64(quint64(m_min) + span);
+}
+
+void ExclusionModel::emitChangedRows(const ExclusionSet &previous)
+{
+    // 只比较网格内的部分：两个集合的区间端点把网格分成若干段，每段内两者的勾选状态都不变，
+    // 逐段比较即可得到状态变化的数字，耗时与区间数成正比，与网格大小无关
+    const qint64 last = lastShownValue();
+    const ExclusionSet before = previous.clipped(m_min, last);
+    const ExclusionSet after = m_excluded.clipped(m_min, last);
+
+    QList<qint64> bounds{m_min};
+    for (const ExclusionSet *set : {&before, &after}) {
+        for (const ExclusionSet::Interval &interval : set->intervals()) {
+            bounds.append(interval.first);
+            if (interval.last < last) {
+                bounds.append(interval.last + 1);
+            }
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    // 相邻或重叠的变化行合并为一次 dataChanged
+    int firstRow = -1;
+    int lastRow = -1;
+    auto flush = [&]() {
+        if (firstRow >= 0) {
+            emit dataChanged(index(firstRow, 0), index(lastRow, ColumnCount - 1), {Qt::CheckStateRole});
+        }
+    };
+    for (qsizetype i = 0; i < bounds.size(); ++i) {
+        const qint64 begin = bounds[i];
+        if (before.contains(begin) == after.contains(begin)) {
+            continue;
+        }
+        const qint64 end = i + 1 < bounds.size() ? bounds[i + 1] - 1 : last;
+        const int beginRow = int((quint64(begin) - quint64(m_min)) / ColumnCount);
+        const int endRow = int((quint64(end) - quint64(m_min)) / ColumnCount);
+        if (firstRow >= 0 && beginRow <= lastRow + 1) {
+            lastRow = std::max(lastRow, endRow);
+            continue;
+        }
+        flush();
+        firstRow = beginRow;
+        lastRow = endRow;
+    }
+    flush();
+}
+
+bool ExclusionModel::isTruncated() const
+{
+    if (m_min > m_max) {
+        return false;
+    }
+    return (quint64(m_max) - quint64(m_min)) / ColumnCount >= quint64(MaxRows);
+}
+
+int ExclusionModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_min > m_max) {
+        return 0;
+    }
+
+    const quint64 rows = (quint64(m_max) - quint64(m_min)) / ColumnCount + 1;
+    return int(std::min<quint64>(rows, MaxRows));
+}
+
+int ExclusionModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ExclusionModel::data(const QModelIndex &index, int role) const
+{
+    qint64 value;
+    if (!valueAt(index, &value)) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString::number(value);
+    case Qt::CheckStateRole:
+        return m_excluded.contains(value) ? Qt::Checked : Qt::Unchecked;
+    default:
+        return QVariant();
+    }
+}
+
+bool ExclusionModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    qint64 number;
+    if (role != Qt::CheckStateRole || !valueAt(index, &number)) {
+        return false;
+    }
+
+    const bool excluded = value.toInt() == Qt::Checked;
+    if (excluded == m_excluded.contains(number)) {
+        return true;
+    }
+
+    if (excluded) {
+        m_excluded.insert(number);
+    } else {
+        m_excluded.remove(number);
+    }
+
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    emit exclusionToggled(number, excluded);
+    return true;
+}
+
+Qt::ItemFlags ExclusionModel::flags(const QModelIndex &index) const
+{
+    qint64 value;
+    if (!valueAt(index, &value)) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+}
+
+bool ExclusionModel::valueAt(const QModelIndex &index, qint64 *value) const
+{
+    if (!index.isValid() || m_min > m_max) {
+        return false;
+    }
+
+    const quint64 offset = quint64(index.row()) * ColumnCount + quint64(index.column());
+    if (offset > (quint64(m_max) - quint64(m_min))) {
+        return false;
+    }
+
+    *value = qint64(quint64(m_min) + offset);
+    return true;
+}
@@ -0,0 +1,46 @@
+// ExclusionModel.h
+#ifndef EXCLUSIONMODEL_H
+#define EXCLUSIONMODEL_H
+
+#include <QAbstractTableModel>
+#include "ExclusionSet.h"
+
+// 排除数字网格的数据模型
+// 把 [min, max] 按每行 ColumnCount 个数字排成表格，勾选状态直接来自排除集合。
+// 模型本身不为每个数字创建任何对象，视图只会请求可见单元格的数据。
+class ExclusionModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ColumnCount = 10;
+    static constexpr int MaxRows = 1000000; // 超出部分不在网格中显示，只能通过文本输入排除
+
+    explicit ExclusionModel(QObject *parent = nullptr);
+
+    void setRange(qint64 min, qint64 max);
+    // 只对勾选状态变化的行发出 dataChanged
+    void setExcludedNumbers(const ExclusionSet &excludedNumbers);
+    const ExclusionSet &excludedNumbers() const { return m_excluded; }
+    bool isTruncated() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+signals:
+    void exclusionToggled(qint64 value, bool excluded);
+
+private:
+    bool valueAt(const QModelIndex &index, qint64 *value) const;
+    qint64 lastShownValue() const; // 网格中最后一个数字，要求 m_min <= m_max
+    void emitChangedRows(const ExclusionSet &previous);
+
+    qint64 m_min = 0;
+    qint64 m_max = -1;
+    ExclusionSet m_excluded;
+};
+
+#endif // EXCLUSIONMODEL_H
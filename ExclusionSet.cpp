@@ -0,0 +1,370 @@
+// ExclusionSet.cpp
+#include "ExclusionSet.h"
+#include <QStringView>
+#include <algorithm>
+#include <bit>
+
+namespace {
+// 区间数达到该值且覆盖范围不超过 区间数 * kDenseSpanPerInterval 时启用位图
+constexpr qint64 kDenseMinIntervals = 64;
+constexpr qint64 kDenseSpanPerInterval = 512;
+
+quint64 mix64(quint64 z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+}
+
+ExclusionSet ExclusionSet::fromValues(QList<qint64> values)
+{
+    ExclusionSet set;
+    std::sort(values.begin(), values.end());
+
+    for (qint64 value : values) {
+        // 已排序，value 不小于上一个区间的终点；用无符号数求差，避免终点为最大值时 +1 溢出
+        if (!set.m_intervals.isEmpty() && quint64(value) - quint64(set.m_intervals.last().last) <= 1) {
+            set.m_intervals.last().last = std::max(set.m_intervals.last().last, value);
+        } else {
+            set.m_intervals.append({value, value});
+        }
+    }
+
+    set.rebuildIndex();
+    return set;
+}
+
+ExclusionSet ExclusionSet::fromIntervals(QList<Interval> intervals)
+{
+    ExclusionSet set;
+    std::sort(intervals.begin(), intervals.end(),
+              [](const Interval &a, const Interval &b) { return a.first < b.first; });
+
+    for (const Interval &interval : intervals) {
+        if (interval.first > interval.last) {
+            continue;
+        }
+        // 用无符号数比较相邻，避免 last 为最大值时 +1 溢出
+        if (!set.m_intervals.isEmpty()
+            && quint64(interval.first) - quint64(set.m_intervals.last().first)
+                   <= quint64(set.m_intervals.last().last) - quint64(set.m_intervals.last().first) + 1) {
+            set.m_intervals.last().last = std::max(set.m_intervals.last().last, interval.last);
+        } else {
+            set.m_intervals.append(interval);
+        }
+    }
+
+    set.rebuildIndex();
+    return set;
+}
+
+ExclusionSet ExclusionSet::fromString(const QString &text, bool *ok)
+{
+    bool valid = true;
+    QList<Interval> intervals;
+    const QList<QStringView> parts = QStringView(text).split(u',', Qt::SkipEmptyParts);
+    intervals.reserve(parts.size());
+    for (QStringView part : parts) {
+        part = part.trimmed();
+        // 第一个字符可能是负号，从第二个字符开始找区间分隔符
+        const qsizetype dash = part.indexOf(u'-', 1);
+        bool firstOk = false;
+        bool lastOk = true;
+        const qint64 first = (dash < 0 ? part : part.left(dash)).toLongLong(&firstOk);
+        const qint64 last = dash < 0 ? first : part.mid(dash + 1).toLongLong(&lastOk);
+        if (firstOk && lastOk && first <= last) {
+            intervals.append({first, last});
+        } else {
+            valid = false;
+        }
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return fromIntervals(std::move(intervals));
+}
+
+QString ExclusionSet::toString() const
+{
+    QString text;
+    for (const Interval &interval : m_intervals) {
+        if (!text.isEmpty()) {
+            text += u',';
+        }
+        text += QString::number(interval.first);
+        if (interval.last != interval.first) {
+            text += u'-';
+            text += QString::number(interval.last);
+        }
+    }
+    return text;
+}
+
+quint64 ExclusionSet::hash() const
+{
+    if (m_intervals.isEmpty()) {
+        return 0;
+    }
+
+    quint64 h = 0x9E3779B97F4A7C15ULL ^ quint64(m_intervals.size());
+    for (const Interval &interval : m_intervals) {
+        h = mix64(h ^ quint64(interval.first));
+        h = mix64(h + quint64(interval.last));
+    }
+    return h | 1; // 非空集合不会与空集合混淆
+}
+
+QList<qint64> ExclusionSet::values() const
+{
+    QList<qint64> result;
+    result.reserve(qsizetype(size()));
+    for (const Interval &interval : m_intervals) {
+        // 到终点即停，终点为最大值时不会递增越界
+        for (qint64 value = interval.first;; ++value) {
+            result.append(value);
+            if (value == interval.last) {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+void ExclusionSet::insert(qint64 value)
+{
+    if (contains(value)) {
+        return;
+    }
+
+    if (m_prefix.isEmpty()) {
+        m_prefix.append(0); // 默认构造的集合还没有前缀计数
+    }
+
+    const qint64 next = intervalIndexAfter(value);
+    const bool joinPrev = next > 0 && quint64(value) - quint64(m_intervals[next - 1].last) == 1;
+    const bool joinNext = next < m_intervals.size() && quint64(m_intervals[next].first) - quint64(value) == 1;
+
+    // 前缀计数与区间同步插入或删除一项，之后的各项加一
+    if (joinPrev && joinNext) {
+        m_intervals[next - 1].last = m_intervals[next].last;
+        m_intervals.removeAt(next);
+        m_prefix.removeAt(next);
+        updateIndex(next, value, 1);
+    } else if (joinPrev) {
+        m_intervals[next - 1].last = value;
+        updateIndex(next, value, 1);
+    } else if (joinNext) {
+        m_intervals[next].first = value;
+        updateIndex(next + 1, value, 1);
+    } else {
+        m_intervals.insert(next, {value, value});
+        const auto before = m_prefix[next];
+        m_prefix.insert(next + 1, before);
+        updateIndex(next + 1, value, 1);
+    }
+}
+
+void ExclusionSet::remove(qint64 value)
+{
+    if (!contains(value)) {
+        return;
+    }
+
+    const qint64 index = intervalIndexAfter(value) - 1;
+    Interval &interval = m_intervals[index];
+
+    if (interval.first == interval.last) {
+        m_intervals.removeAt(index);
+        m_prefix.removeAt(index + 1);
+        updateIndex(index + 1, value, -1);
+    } else if (interval.first == value) {
+        ++interval.first;
+        updateIndex(index + 1, value, -1);
+    } else if (interval.last == value) {
+        --interval.last;
+        updateIndex(index + 1, value, -1);
+    } else {
+        const Interval tail{value + 1, interval.last};
+        interval.last = value - 1;
+        m_prefix.insert(index + 1, m_prefix[index] + interval.length()); // 插入区间后 interval 可能失效
+        m_intervals.insert(index + 1, tail);
+        updateIndex(index + 2, value, -1);
+    }
+}
+
+void ExclusionSet::clear()
+{
+    m_intervals.clear();
+    rebuildIndex();
+}
+
+bool ExclusionSet::contains(qint64 value) const
+{
+    if (m_dense) {
+        const DenseIndex &dense = *m_dense;
+        const quint64 offset = quint64(value) - quint64(dense.base);
+        if (value < dense.base || offset >= dense.bits.size() * 64) {
+            return false;
+        }
+        return (dense.bits[offset / 64] >> (offset % 64)) & 1;
+    }
+
+    const qint64 next = intervalIndexAfter(value);
+    return next > 0 && m_intervals[next - 1].last >= value;
+}
+
+quint64 ExclusionSet::rank(qint64 value) const
+{
+    if (m_intervals.isEmpty() || value <= m_intervals.first().first) {
+        return 0;
+    }
+
+    if (m_dense) {
+        const DenseIndex &dense = *m_dense;
+        const quint64 offset = quint64(value) - quint64(dense.base);
+        if (offset < dense.bits.size() * 64) {
+            const quint64 word = dense.bits[offset / 64] & ((quint64(1) << (offset % 64)) - 1);
+            return dense.wordRank[offset / 64] + std::popcount(word);
+        }
+        return size();
+    }
+
+    const qint64 next = intervalIndexAfter(value - 1);
+    // 前 next 个区间的起点都小于 value，最后一个可能跨过 value
+    const Interval &last = m_intervals[next - 1];
+    return m_prefix[next] - (last.last >= value ? quint64(last.last) - quint64(value) + 1 : 0);
+}
+
+quint64 ExclusionSet::countInRange(qint64 first, qint64 last) const
+{
+    if (first > last) {
+        return 0;
+    }
+    return rank(last) + (contains(last) ? 1 : 0) - rank(first);
+}
+
+qint64 ExclusionSet::selectAvailable(qint64 min, quint64 index) const
+{
+    // 区间 i 之前的可用数字个数为 first[i] - min - prefix[i]，随 i 单调不减；
+    // 找出满足该值 <= index 的区间个数 k，结果即 min + index + prefix[k]
+    qint64 lo = 0;
+    qint64 hi = m_intervals.size();
+    while (lo < hi) {
+        const qint64 mid = lo + (hi - lo) / 2;
+        if (quint64(m_intervals[mid].first) - quint64(min) - m_prefix[mid] <= index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // 按无符号运算，跨越整个 64 位范围时也不会溢出
+    const quint64 skipped = m_prefix.isEmpty() ? 0 : m_prefix[lo];
+    return qint64(quint64(min) + index + skipped);
+}
+
+ExclusionSet ExclusionSet::clipped(qint64 first, qint64 last) const
+{
+    if (m_intervals.isEmpty() || (m_intervals.first().first >= first && m_intervals.last().last <= last)) {
+        return *this;
+    }
+
+    ExclusionSet set;
+    const qint64 begin = std::max<qint64>(0, intervalIndexAfter(first) - 1);
+    for (qint64 i = begin; i < m_intervals.size() && m_intervals[i].first <= last; ++i) {
+        const Interval &interval = m_intervals[i];
+        if (interval.last < first) {
+            continue;
+        }
+        set.m_intervals.append({std::max(interval.first, first), std::min(interval.last, last)});
+    }
+    set.rebuildIndex();
+    return set;
+}
+
+qint64 ExclusionSet::intervalIndexAfter(qint64 value) const
+{
+    auto it = std::upper_bound(m_intervals.cbegin(), m_intervals.cend(), value,
+                               [](qint64 v, const Interval &interval) { return v < interval.first; });
+    return it - m_intervals.cbegin();
+}
+
+void ExclusionSet::updateIndex(qsizetype from, qint64 value, int delta)
+{
+    for (qsizetype i = from; i < m_prefix.size(); ++i) {
+        m_prefix[i] += delta;
+    }
+
+    if (m_intervals.isEmpty()) {
+        m_dense.reset();
+        return;
+    }
+    if (!m_dense) {
+        // 区间数刚达到下限时检查是否改用位图，之后不再每次检查
+        if (m_intervals.size() == kDenseMinIntervals) {
+            rebuildDense();
+        }
+        return;
+    }
+
+    const quint64 offset = quint64(value) - quint64(m_dense->base);
+    if (value < m_dense->base || offset >= m_dense->bits.size() * 64) {
+        // 超出位图覆盖的范围
+        rebuildDense();
+        return;
+    }
+    if (m_dense.use_count() > 1) {
+        m_dense = std::make_shared<DenseIndex>(*m_dense);
+    }
+    DenseIndex &dense = *m_dense;
+    dense.bits[offset / 64] ^= quint64(1) << (offset % 64);
+    for (size_t w = offset / 64 + 1; w < dense.wordRank.size(); ++w) {
+        dense.wordRank[w] += delta;
+    }
+}
+
+void ExclusionSet::rebuildIndex()
+{
+    m_prefix.resize(m_intervals.size() + 1);
+    m_prefix[0] = 0;
+    for (qint64 i = 0; i < m_intervals.size(); ++i) {
+        m_prefix[i + 1] = m_prefix[i] + m_intervals[i].length();
+    }
+
+    rebuildDense();
+}
+
+void ExclusionSet::rebuildDense()
+{
+    m_dense.reset();
+
+    const qint64 intervalCount = m_intervals.size();
+    if (intervalCount < kDenseMinIntervals) {
+        return;
+    }
+
+    const quint64 span = quint64(m_intervals.last().last) - quint64(m_intervals.first().first);
+    if (span >= quint64(intervalCount * kDenseSpanPerInterval)) {
+        return;
+    }
+
+    auto dense = std::make_shared<DenseIndex>();
+    dense->base = m_intervals.first().first;
+    dense->bits.assign(span / 64 + 1, 0);
+    for (const Interval &interval : m_intervals) {
+        const quint64 firstOffset = quint64(interval.first) - quint64(dense->base);
+        const quint64 lastOffset = quint64(interval.last) - quint64(dense->base);
+        for (quint64 offset = firstOffset; offset <= lastOffset; ++offset) {
+            dense->bits[offset / 64] |= quint64(1) << (offset % 64);
+        }
+    }
+
+    dense->wordRank.resize(dense->bits.size());
+    qint64 running = 0;
+    for (size_t w = 0; w < dense->bits.size(); ++w) {
+        dense->wordRank[w] = running;
+        running += std::popcount(dense->bits[w]);
+    }
+    m_dense = std::move(dense);
+}
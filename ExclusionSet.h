@@ -0,0 +1,82 @@
+// ExclusionSet.h
+#ifndef EXCLUSIONSET_H
+#define EXCLUSIONSET_H
+
+#include <QList>
+#include <QString>
+#include <memory>
+#include <vector>
+
+// 排除数字集合
+// 以排好序、已合并的闭区间列表保存，支持 O(log n) 的成员查询和秩/选择查询；
+// 当区间很碎而覆盖范围较小时(密集)，额外建立位图和每个字的前缀计数，把成员查询和秩查询降到 O(1)。
+// 各个副本共享同一份位图，复制集合的代价与位图大小无关；insert/remove 只改动受影响的区间、前缀计数和一位，
+// 位图仍与其他副本共享时先复制一份再改。
+class ExclusionSet
+{
+public:
+    struct Interval
+    {
+        qint64 first;
+        qint64 last; // 闭区间
+
+        // 按无符号数计算，跨越大半个 64 位范围时也不会溢出(覆盖全部 2^64 个数字时回绕为 0)
+        quint64 length() const { return quint64(last) - quint64(first) + 1; }
+        bool operator==(const Interval &other) const = default;
+    };
+
+    ExclusionSet() = default;
+
+    static ExclusionSet fromValues(QList<qint64> values);
+    static ExclusionSet fromIntervals(QList<Interval> intervals);
+    // 逗号分隔的数字和闭区间，如 "1-5,8,10-12"；负数照常书写，如 "-5--3"。文本长度与区间数成正比
+    // 无法解析的部分被跳过，ok 非空时其中有这样的部分则置为 false
+    static ExclusionSet fromString(const QString &text, bool *ok = nullptr);
+    QString toString() const;
+
+    void insert(qint64 value);
+    void remove(qint64 value);
+    void clear();
+
+    bool contains(qint64 value) const;
+    bool isEmpty() const { return m_intervals.isEmpty(); }
+    quint64 size() const { return m_prefix.isEmpty() ? 0 : m_prefix.last(); }
+    const QList<Interval> &intervals() const { return m_intervals; }
+    QList<qint64> values() const;
+
+    // 小于 value 的排除数字个数
+    quint64 rank(qint64 value) const;
+    // [first, last] 内的排除数字个数
+    quint64 countInRange(qint64 first, qint64 last) const;
+    // 从 min 开始第 index 个(从 0 开始)未被排除的数字，要求集合中没有小于 min 的数字
+    qint64 selectAvailable(qint64 min, quint64 index) const;
+
+    // 只保留 [first, last] 内的部分；已经都在范围内时直接共享
+    ExclusionSet clipped(qint64 first, qint64 last) const;
+
+    // 由区间端点计算的 64 位哈希，空集合为 0
+    quint64 hash() const;
+
+    bool operator==(const ExclusionSet &other) const { return m_intervals == other.m_intervals; }
+
+private:
+    void rebuildIndex();
+    void rebuildDense();
+    // 单个数字加入(delta = 1)或移出(delta = -1)后，前缀计数从 from 起整体加减，位图只改一位
+    void updateIndex(qsizetype from, qint64 value, int delta);
+    qint64 intervalIndexAfter(qint64 value) const; // 第一个 first > value 的区间下标
+
+    QList<Interval> m_intervals;
+    QList<quint64> m_prefix; // m_prefix[i] 为前 i 个区间包含的数字个数，长度为区间数 + 1
+
+    // 密集位图加速
+    struct DenseIndex
+    {
+        qint64 base = 0;
+        std::vector<quint64> bits;
+        std::vector<qint64> wordRank; // wordRank[w] 为第 w 个字之前置位的个数
+    };
+    std::shared_ptr<DenseIndex> m_dense;
+};
+
+#endif // EXCLUSIONSET_H
@@ -0,0 +1,214 @@
+// GenerationJob.cpp
+#include "GenerationJob.h"
+#include "BatchGenerator.h"
+#include "UniqueSampler.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <limits>
+
+GenerationJob::GenerationJob(Request request, HistoryWriter *historyWriter, QObject *parent)
+    : QObject(parent), m_request(std::move(request)), m_historyWriter(historyWriter)
+{
+}
+
+bool GenerationJob::validate(qint64 min, qint64 max, qint64 count, bool unique, const ExclusionSet &excluded,
+                             QString *errorString)
+{
+    if (min >= max) {
+        *errorString = "最大值必须大于最小值";
+        return false;
+    }
+    // 数字个数要能用 64 位无符号数表示
+    if (quint64(max) - quint64(min) == std::numeric_limits<quint64>::max()) {
+        *errorString = "范围不能覆盖全部 64 位整数";
+        return false;
+    }
+
+    // 计算可用数字范围
+    quint64 availableNumbers = UniqueSampler::availableCount(min, max, excluded);
+    if (availableNumbers == 0) {
+        *errorString = "所有可能的数字都被排除了！";
+        return false;
+    }
+
+    if (unique && quint64(count) > availableNumbers) {
+        *errorString = QString("请求的数量(%1)超过了可用数字的数量(%2)").arg(count).arg(availableNumbers);
+        return false;
+    }
+
+    return true;
+}
+
+bool GenerationJob::validate(const WeightTable &weights, qint64 count, bool unique, QString *errorString)
+{
+    if (weights.positiveCount() == 0) {
+        *errorString = "没有权重大于 0 的可用数字";
+        return false;
+    }
+
+    if (unique && quint64(count) > weights.positiveCount()) {
+        *errorString = QString("请求的数量(%1)超过了权重大于 0 的数字的数量(%2)")
+                           .arg(count)
+                           .arg(weights.positiveCount());
+        return false;
+    }
+
+    // 不重复时要记住已抽到的数字，生成到文件也不能做到内存与数量无关
+    if (unique && count > MaxInMemoryCount) {
+        *errorString = QString("按权重不重复抽样时数量不能超过 %1").arg(MaxInMemoryCount);
+        return false;
+    }
+
+    return true;
+}
+
+void GenerationJob::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (m_request.draws > 1) {
+        generateBatch();
+    } else if (m_request.outputPath.isEmpty()) {
+        generateInMemory();
+    } else {
+        generateToFile();
+    }
+    m_elapsed = timer.nsecsElapsed();
+
+    emit finished();
+}
+
+void GenerationJob::generateInMemory()
+{
+    auto progressCallback = [this](qint64 done, qint64 total) { return reportProgress(done, total); };
+
+    if (m_request.weights) {
+        // 按权重抽样：查表很快，分段进行只为报告进度和响应取消
+        WeightTable::Sampler sampler(m_request.weights, m_request.unique, m_request.engine, m_request.seed);
+        m_numbers.resize(m_request.count);
+        for (qint64 done = 0; done < m_request.count && !isCanceled();) {
+            const qint64 chunk = std::min(m_request.count - done, UniqueSampler::ProgressInterval);
+            sampler.fill(std::span<qint64>(m_numbers.data() + done, size_t(chunk)));
+            done += chunk;
+            reportProgress(done, m_request.count);
+        }
+    } else if (usesShuffle()) {
+        m_numbers = UniqueSampler::sample(m_request.min, m_request.max, m_request.excluded, m_request.count,
+                                          m_request.engine, m_request.seed, progressCallback);
+    } else {
+        // 大批量或可重复抽样：按块分给多个线程，结果只由种子决定
+        m_numbers.resize(m_request.count);
+        ParallelGenerator::generate(parallelParams(), 0, m_request.count, m_numbers.data(), progressCallback);
+    }
+    if (isCanceled()) {
+        m_numbers.clear();
+        m_status = Status::Canceled;
+        return;
+    }
+
+    appendHistory(); // 自动保存到历史记录
+
+    m_status = Status::Finished;
+}
+
+void GenerationJob::generateToFile()
+{
+    auto progressCallback = [this](qint64 done, qint64 total) { return reportProgress(done, total); };
+
+    StreamGenerator::Result result;
+    if (m_request.weights) {
+        WeightTable::Sampler sampler(m_request.weights, m_request.unique, m_request.engine, m_request.seed);
+        result = StreamGenerator::generateToFile(m_request.outputPath, &sampler, m_request.count, m_request.layout,
+                                                 progressCallback, &m_errorString);
+    } else if (usesShuffle()) {
+        // 与生成到内存相同的洗牌；数量低于 ParallelThreshold，整体放在内存中也不大
+        const QList<qint64> numbers = UniqueSampler::sample(m_request.min, m_request.max, m_request.excluded,
+                                                            m_request.count, m_request.engine, m_request.seed,
+                                                            progressCallback);
+        result = isCanceled() ? StreamGenerator::Result::Canceled
+                              : StreamGenerator::writeToFile(m_request.outputPath, numbers, m_request.layout,
+                                                             progressCallback, &m_errorString);
+    } else {
+        result = StreamGenerator::generateToFile(m_request.outputPath, parallelParams(), m_request.count,
+                                                 m_request.layout, progressCallback, &m_errorString);
+    }
+    finishFile(result);
+}
+
+void GenerationJob::generateBatch()
+{
+    auto progressCallback = [this](qint64 done, qint64 total) { return reportProgress(done, total); };
+
+    // 批量抽取只写入文件，各次抽取的结果不保存在内存中
+    if (m_request.outputPath.isEmpty()) {
+        m_errorString = "批量抽取需要指定输出文件";
+        m_status = Status::Failed;
+        return;
+    }
+    if (m_request.count > MaxBatchCount) {
+        m_errorString = QString("批量抽取时每次的数量不能超过 %1").arg(MaxBatchCount);
+        m_status = Status::Failed;
+        return;
+    }
+    const BatchGenerator::Params params{parallelParams(), m_request.weights, m_request.count, m_request.draws};
+    finishFile(BatchGenerator::generateToFile(m_request.outputPath, params, progressCallback, &m_errorString));
+}
+
+void GenerationJob::finishFile(StreamGenerator::Result result)
+{
+    switch (result) {
+    case StreamGenerator::Result::Finished:
+        appendHistory();
+        m_status = Status::Finished;
+        break;
+    case StreamGenerator::Result::Canceled:
+        m_status = Status::Canceled;
+        break;
+    case StreamGenerator::Result::Failed:
+        m_status = Status::Failed;
+        break;
+    }
+}
+
+bool GenerationJob::usesShuffle() const
+{
+    return !m_request.weights && !m_request.distribution && m_request.unique && m_request.count < ParallelThreshold;
+}
+
+ParallelGenerator::Params GenerationJob::parallelParams() const
+{
+    return {m_request.min, m_request.max, m_request.excluded, m_request.unique, m_request.seed, m_request.engine,
+            m_request.distribution};
+}
+
+void GenerationJob::appendHistory()
+{
+    if (m_request.replay || !m_historyWriter) {
+        return;
+    }
+
+    // 只放入写入队列，磁盘写入由 HistoryWriter 的线程完成；数字与结果共享数据，不复制
+    HistoryLog::Entry entry;
+    entry.record = {QDateTime::currentDateTime(), m_request.min, m_request.max, m_request.count, m_request.excluded,
+                    m_request.unique, m_request.engine, m_request.seed, m_request.excluded.hash(),
+                    m_request.outputPath, m_request.draws};
+    if (m_request.draws > 1) {
+        // 整批只记一条，抽取结果在输出文件中
+        entry.kind = HistoryLog::Kind::Batch;
+    } else if (m_request.seeded && !m_request.weights && !m_request.distribution) {
+        // 权重和分布参数不进入历史记录，这些结果无法只凭种子重放
+        entry.kind = HistoryLog::Kind::Seed;
+    } else if (m_request.outputPath.isEmpty()) {
+        entry.kind = HistoryLog::Kind::Numbers;
+        entry.numbers = m_numbers;
+    } else {
+        entry.kind = HistoryLog::Kind::Stream;
+    }
+    m_historyWriter->enqueue(std::move(entry));
+}
+
+bool GenerationJob::reportProgress(qint64 done, qint64 total)
+{
+    emit progress(done, total);
+    return !isCanceled();
+}
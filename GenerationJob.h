@@ -0,0 +1,102 @@
+// GenerationJob.h
+#ifndef GENERATIONJOB_H
+#define GENERATIONJOB_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <atomic>
+#include "ExclusionSet.h"
+#include "HistoryWriter.h"
+#include "NumberSerializer.h"
+#include "ParallelGenerator.h"
+#include "StreamGenerator.h"
+#include "WeightTable.h"
+
+// 一次生成任务，在工作线程中执行生成，完成后把历史记录交给 HistoryWriter
+// 通过 cancel() 取消；结果在 finished() 之后由界面线程用 take*() 移走，不做拷贝。
+class GenerationJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Status {
+        Running,
+        Finished,
+        Canceled,
+        Failed
+    };
+
+    struct Request
+    {
+        qint64 min = 0;
+        qint64 max = 0;
+        qint64 count = 0;
+        ExclusionSet excluded; // 已裁剪到 [min, max]
+        QString outputPath;    // 非空时流式生成到该文件，结果不保存在内存中
+        bool unique = true;    // false 时允许重复
+        quint64 seed = 0;      // 随机数引擎的种子
+        EngineType engine = EngineType::Xoshiro256StarStar;
+        bool seeded = false;   // 可复现模式：历史记录只保存种子和参数
+        bool replay = false;   // 重放历史记录，不再写入历史
+        NumberSerializer::Layout layout = NumberSerializer::Layout::Grouped; // 输出文件格式
+        std::shared_ptr<const WeightTable> weights; // 非空时按权重抽样，历史记录保存结果而不是种子
+        qint64 draws = 1; // 大于 1 时为批量抽取：独立抽取 draws 次，每次 count 个，逐行写入 outputPath
+        std::shared_ptr<const Distribution> distribution; // 非空时按非均匀分布可重复抽样
+    };
+
+    // 不重复抽样数量达到该值时改用多线程生成；生成到内存和生成到文件按同一标准选择，
+    // 只保存种子的记录无论当初输出到哪里，重放时都得到相同的结果
+    static constexpr qint64 ParallelThreshold = 262144;
+    static constexpr qint64 MaxInMemoryCount = 10000000; // 超过该数量只能流式生成到文件
+    static constexpr qint64 MaxBatchCount = MaxInMemoryCount; // 批量抽取时每次的数量上限，每次抽取整体放在内存中
+
+    // 检查范围、排除集合和数量是否能完成抽样，失败时给出原因
+    static bool validate(qint64 min, qint64 max, qint64 count, bool unique, const ExclusionSet &excluded,
+                         QString *errorString);
+    // 按权重抽样时还要求有权重大于 0 的数字，不重复抽样的数量不超过它们的个数，也不超过 MaxInMemoryCount
+    static bool validate(const WeightTable &weights, qint64 count, bool unique, QString *errorString);
+
+    // historyWriter 为空时不保存历史记录
+    GenerationJob(Request request, HistoryWriter *historyWriter, QObject *parent = nullptr);
+
+    const Request &request() const { return m_request; }
+    Status status() const { return m_status; }
+    QString errorString() const { return m_errorString; }
+    // 生成(含写入文件)所用的时间
+    qint64 elapsedNanoseconds() const { return m_elapsed; }
+
+    void cancel() { m_canceled.store(true, std::memory_order_relaxed); }
+    bool isCanceled() const { return m_canceled.load(std::memory_order_relaxed); }
+
+    QList<qint64> takeNumbers() { return std::move(m_numbers); }
+
+public slots:
+    void run();
+
+signals:
+    void progress(qint64 done, qint64 total);
+    void finished();
+
+private:
+    void generateInMemory();
+    void generateToFile();
+    void generateBatch();
+    void finishFile(StreamGenerator::Result result);
+    // 用 UniqueSampler 洗牌而不是 ParallelGenerator
+    bool usesShuffle() const;
+    ParallelGenerator::Params parallelParams() const;
+    void appendHistory();
+    bool reportProgress(qint64 done, qint64 total);
+
+    Request m_request;
+    HistoryWriter *m_historyWriter;
+    Status m_status = Status::Running;
+    QString m_errorString;
+    qint64 m_elapsed = 0;
+    std::atomic<bool> m_canceled{false};
+
+    QList<qint64> m_numbers;
+};
+
+#endif // GENERATIONJOB_H
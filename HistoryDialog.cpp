@@ -0,0 +1,147 @@
+// HistoryDialog.cpp
+#include "HistoryDialog.h"
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QLabel>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+HistoryDialog::HistoryDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle("📜 历史记录");
+    setMinimumSize(640, 420);
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #f8f9fa;
+            color: #212529;
+            font-family: 'Segoe UI', 'Microsoft YaHei', sans-serif;
+        }
+        QLabel {
+            color: #495057;
+            font-size: 14px;
+        }
+        QListView {
+            background-color: white;
+            border: 2px solid #dee2e6;
+            border-radius: 8px;
+            padding: 6px;
+            font-family: 'Consolas', 'Monospace';
+            font-size: 14px;
+            color: #212529;
+        }
+        QListView::item {
+            padding: 6px;
+        }
+        QListView::item:selected {
+            background-color: #4a90e2;
+            color: white;
+        }
+        QPushButton {
+            background: qlineargradient(x1: 0, y1: 0, x2: 0, y2: 1,
+                stop: 0 #6c9bd2, stop: 1 #4a7bb0);
+            color: white;
+            border: 2px solid #8fb4e2;
+            border-radius: 8px;
+            padding: 10px 24px;
+            font-weight: bold;
+            font-size: 13px;
+            min-width: 80px;
+        }
+        QPushButton:hover {
+            background: qlineargradient(x1: 0, y1: 0, x2: 0, y2: 1,
+                stop: 0 #5a8ac2, stop: 1 #3a6ba0);
+        }
+        QPushButton:disabled {
+            background: #d1d9e0;
+            color: #8a99a8;
+            border-color: #d1d9e0;
+        }
+    )");
+
+    // 列表直接读取内存映射的历史日志，只格式化可见行
+    historyModel = new HistoryModel(this);
+    recordView = new QListView();
+    recordView->setModel(historyModel);
+    recordView->setUniformItemSizes(true);
+    recordView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    openButton = new QPushButton("🔁 查看结果");
+    QPushButton *exportButton = new QPushButton("📤 导出文本");
+    QPushButton *closeButton = new QPushButton("关闭");
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(exportButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(openButton);
+    buttonLayout->addSpacing(15);
+    buttonLayout->addWidget(closeButton);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(15);
+    mainLayout->setContentsMargins(25, 25, 25, 25);
+    mainLayout->addWidget(new QLabel("选择一条记录查看结果，可复现模式的记录会按种子重新生成:"));
+    mainLayout->addWidget(recordView, 1);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(recordView, &QListView::doubleClicked, this, &HistoryDialog::openSelected);
+    connect(recordView->selectionModel(), &QItemSelectionModel::currentChanged, this, &HistoryDialog::updateButtons);
+    connect(openButton, &QPushButton::clicked, this, &HistoryDialog::openSelected);
+    connect(exportButton, &QPushButton::clicked, this, &HistoryDialog::exportText);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::reject);
+    // 关闭后不再占用日志文件，后台线程可以关闭和删除分段
+    connect(this, &QDialog::finished, historyModel, &HistoryModel::clear);
+}
+
+void HistoryDialog::reload()
+{
+    historyModel->reload();
+    updateButtons();
+}
+
+void HistoryDialog::updateButtons()
+{
+    // 流式记录只有输出文件，旧算法的种子记录无法重放
+    const QModelIndex current = recordView->currentIndex();
+    bool enabled = false;
+    if (current.isValid()) {
+        enabled = historyModel->kind(current.row()) == HistoryLog::Kind::Numbers
+                  || historyModel->isReplayable(current.row());
+    }
+    openButton->setEnabled(enabled);
+}
+
+void HistoryDialog::openSelected()
+{
+    const QModelIndex current = recordView->currentIndex();
+    if (!current.isValid()) {
+        return;
+    }
+
+    const int row = current.row();
+    const DrawRecord record = historyModel->record(row);
+
+    if (historyModel->kind(row) == HistoryLog::Kind::Numbers) {
+        const QList<qint64> numbers = historyModel->numbers(row);
+        accept();
+        emit numbersRequested(record, numbers);
+    } else if (historyModel->isReplayable(row)) {
+        accept();
+        emit replayRequested(record);
+    }
+}
+
+void HistoryDialog::exportText()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, "导出历史记录", HistoryFile::defaultPath(),
+                                                    "文本文件 (*.txt);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    if (!HistoryLog::exportText(filePath)) {
+        QMessageBox::warning(this, "错误", "导出历史记录失败");
+        return;
+    }
+    QMessageBox::information(this, "导出完成", QString("历史记录已导出到\n%1").arg(filePath));
+}
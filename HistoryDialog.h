@@ -0,0 +1,38 @@
+// HistoryDialog.h
+#ifndef HISTORYDIALOG_H
+#define HISTORYDIALOG_H
+
+#include <QDialog>
+#include <QListView>
+#include <QPushButton>
+#include "HistoryFile.h"
+#include "HistoryModel.h"
+
+// 历史记录列表
+// 保存了数字的记录直接显示；可复现模式的记录由主窗口按种子重新生成结果。
+class HistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryDialog(QWidget *parent = nullptr);
+
+    // 重新读取历史日志
+    void reload();
+
+signals:
+    void replayRequested(const DrawRecord &record);
+    void numbersRequested(const DrawRecord &record, const QList<qint64> &numbers);
+
+private slots:
+    void openSelected();
+    void updateButtons();
+    void exportText();
+
+private:
+    QListView *recordView;
+    HistoryModel *historyModel;
+    QPushButton *openButton;
+};
+
+#endif // HISTORYDIALOG_H
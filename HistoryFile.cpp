@@ -0,0 +1,156 @@
+// HistoryFile.cpp
+#include "HistoryFile.h"
+#include "NumberSerializer.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+
+QString HistoryFile::defaultPath()
+{
+    return QDir::current().filePath("history.txt");
+}
+
+void HistoryFile::writeNumbersRecord(QTextStream &out, const DrawRecord &record, const QList<qint64> &numbers)
+{
+    out << QString("=").repeated(50) << "\n";
+    writeRecord(out, record, numbers, false);
+}
+
+void HistoryFile::writeStreamRecord(QTextStream &out, const DrawRecord &record)
+{
+    out << QString("=").repeated(50) << "\n";
+    out << "生成时间: " << record.time.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+    out << "范围: " << record.min << " - " << record.max << "\n";
+    out << "数量: " << record.count << "\n";
+    if (record.draws > 1) {
+        out << "抽取次数: " << record.draws << "\n";
+        out << "抽样方式: " << (record.unique ? "不重复" : "可重复") << "\n";
+    }
+    out << "输出文件: " << record.outputPath << "\n\n";
+}
+
+void HistoryFile::writeSeedRecord(QTextStream &out, const DrawRecord &record)
+{
+    out << QString("=").repeated(50) << "\n";
+    out << "生成时间: " << record.time.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+    out << "范围: " << record.min << " - " << record.max << "\n";
+    out << "数量: " << record.count << "\n";
+    out << "抽样方式: " << (record.unique ? "不重复" : "可重复") << "\n";
+    out << "引擎: " << engineName(record.engine) << "\n";
+    out << "种子: " << record.seed << "\n";
+    out << "排除哈希: ";
+    if (record.exclusionHash == 0) {
+        out << "无";
+    } else {
+        out << QString::number(record.exclusionHash, 16);
+    }
+    out << "\n";
+    out << "算法版本: " << SeedRecordVersion << "\n";
+    if (!record.outputPath.isEmpty()) {
+        out << "输出文件: " << record.outputPath << "\n";
+    }
+    out << "\n";
+}
+
+bool HistoryFile::loadExclusionSet(quint64 hash, ExclusionSet *set)
+{
+    if (hash == 0) {
+        *set = ExclusionSet();
+        return true;
+    }
+
+    QFile file(exclusionPath(hash));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    // 每行一个闭区间："first last"
+    QList<ExclusionSet::Interval> intervals;
+    QTextStream in(&file);
+    QString line;
+    while (in.readLineInto(&line)) {
+        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        if (parts.size() != 2) {
+            continue;
+        }
+        intervals.append({parts[0].toLongLong(), parts[1].toLongLong()});
+    }
+
+    *set = ExclusionSet::fromIntervals(std::move(intervals));
+    return set->hash() == hash;
+}
+
+QString HistoryFile::exclusionPath(quint64 hash)
+{
+    return QDir::current().filePath(QString("history_exclusions/%1.txt").arg(hash, 16, 16, QChar('0')));
+}
+
+bool HistoryFile::storeExclusionSet(const ExclusionSet &set)
+{
+    if (set.isEmpty()) {
+        return true;
+    }
+
+    const QString path = exclusionPath(set.hash());
+    if (QFile::exists(path)) {
+        return true; // 相同的排除集合只保存一次
+    }
+    QDir::current().mkpath("history_exclusions");
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream out(&file);
+    for (const ExclusionSet::Interval &interval : set.intervals()) {
+        out << interval.first << " " << interval.last << "\n";
+    }
+    out.flush();
+    return file.commit();
+}
+
+void HistoryFile::writeRecord(QTextStream &out, const DrawRecord &record, const QList<qint64> &numbers,
+                              bool includeHeader)
+{
+    if (includeHeader) {
+        out << "随机数生成记录\n";
+        out << "生成时间: " << record.time.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+        out << "范围: " << record.min << " - " << record.max << "\n";
+        out << "数量: " << record.count << "\n";
+        out << "排除数字: ";
+
+        if (!record.excluded.isEmpty()) {
+            // 按区间书写，不逐个展开，区间再大输出长度也只与区间数有关
+            const QList<ExclusionSet::Interval> &intervals = record.excluded.intervals();
+            for (int i = 0; i < intervals.size(); ++i) {
+                out << intervals[i].first;
+                if (intervals[i].last != intervals[i].first) {
+                    out << "-" << intervals[i].last;
+                }
+                if (i < intervals.size() - 1) {
+                    out << ", ";
+                }
+            }
+        } else {
+            out << "无";
+        }
+        out << "\n\n";
+    } else {
+        out << "生成时间: " << record.time.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+        out << "范围: " << record.min << " - " << record.max << "\n";
+        out << "数量: " << record.count << "\n";
+    }
+
+    out << "生成的随机数:\n";
+    // 数字部分绕过 QTextStream，直接按大块写入设备
+    if (out.device()) {
+        out.flush();
+        NumberSerializer serializer(NumberSerializer::Layout::Grouped, numbers.size());
+        serializer.write(out.device(), numbers.constData(), numbers.size());
+        serializer.flush(out.device());
+    } else {
+        out << NumberSerializer::toString(numbers);
+    }
+    out << "\n\n";
+}
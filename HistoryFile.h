@@ -0,0 +1,59 @@
+// HistoryFile.h
+#ifndef HISTORYFILE_H
+#define HISTORYFILE_H
+
+#include <QDateTime>
+#include <QList>
+#include <QTextStream>
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+
+// 一次生成的参数
+struct DrawRecord
+{
+    QDateTime time;
+    qint64 min = 0;
+    qint64 max = 0;
+    qint64 count = 0;
+    ExclusionSet excluded;
+
+    // 可复现模式下重放所需的参数
+    bool unique = true;
+    EngineType engine = EngineType::Xoshiro256StarStar;
+    quint64 seed = 0;
+    quint64 exclusionHash = 0; // 从历史日志读取时只有哈希，excluded 为空
+    QString outputPath;        // 流式生成的输出文件
+    qint64 draws = 1;          // 批量抽取的次数，count 为每次的数量
+};
+
+// 历史记录的文本格式(原 history.txt 的布局)和排除集合存储，不依赖界面，可在工作线程中调用
+// 历史本身保存在二进制的 HistoryLog 中，文本只在导出时生成。
+class HistoryFile
+{
+public:
+    // 生成算法改变时递增，旧的种子记录不再重放
+    // 2: 写入文件的小数量不重复抽样改用 UniqueSampler，与重放一致
+    static constexpr int SeedRecordVersion = 2;
+
+    // 导出文本的默认位置
+    static QString defaultPath();
+
+    // 各类记录的文本格式，每条以分隔线开头
+    static void writeNumbersRecord(QTextStream &out, const DrawRecord &record, const QList<qint64> &numbers);
+    // 流式结果可能非常大，只记录参数和输出文件位置
+    static void writeStreamRecord(QTextStream &out, const DrawRecord &record);
+    // 可复现模式：只记录种子、参数和排除集合的哈希
+    static void writeSeedRecord(QTextStream &out, const DrawRecord &record);
+
+    static void writeRecord(QTextStream &out, const DrawRecord &record, const QList<qint64> &numbers,
+                            bool includeHeader = true);
+
+    // 排除集合按哈希在 history_exclusions 目录中只保存一份，记录中只保存哈希
+    static bool storeExclusionSet(const ExclusionSet &set);
+    static bool loadExclusionSet(quint64 hash, ExclusionSet *set);
+
+private:
+    static QString exclusionPath(quint64 hash);
+};
+
+#endif // HISTORYFILE_H
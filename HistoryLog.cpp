@@ -0,0 +1,557 @@
+// HistoryLog.cpp
+#include "HistoryLog.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QTextStream>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "历史日志按小端序直接读写头部");
+
+namespace {
+constexpr qsizetype kEncodeBufferSize = 1024 * 1024;
+
+int varintSize(quint64 value)
+{
+    return std::max(1, (int(std::bit_width(value)) + 6) / 7);
+}
+
+char *writeVarint(char *out, quint64 value)
+{
+    while (value >= 0x80) {
+        *out++ = char(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = char(value);
+    return out;
+}
+
+bool readVarint(const uchar *&in, const uchar *end, quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        const uchar byte = *in++;
+        result |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 界面、rand-full-cli 和 rand-full-daemon 可能同时写同一个日志，修改日志、索引或分段前都要持有该锁。
+// 持锁的进程退出后锁自动失效；压缩大分段可能持锁很久，因此不按持锁时间判断锁是否失效。
+bool lockLog(QLockFile &lock)
+{
+    lock.setStaleLockTime(0);
+    return lock.lock();
+}
+}
+
+QString HistoryLog::defaultPath()
+{
+    return QDir::current().filePath("history.bin");
+}
+
+QString HistoryLog::indexPath(const QString &logPath)
+{
+    QString path = logPath;
+    if (path.endsWith(".bin")) {
+        path.chop(4);
+    } else if (path.endsWith(".binz")) {
+        path.chop(5);
+    }
+    return path + ".idx";
+}
+
+QString HistoryLog::lockPath(const QString &logPath)
+{
+    return logPath + ".lock";
+}
+
+QStringList HistoryLog::segments(const QString &logPath)
+{
+    const QFileInfo info(logPath);
+    const QDir dir = info.dir();
+    const QString prefix = info.completeBaseName() + "-";
+
+    // 文件名中是首条记录的时间，按名字排序即按时间排序；压缩中断时同名的 .bin 和 .binz 只取 .binz
+    QStringList result;
+    const QStringList names = dir.entryList({prefix + "*.bin", prefix + "*.binz"}, QDir::Files, QDir::Name);
+    for (const QString &name : names) {
+        if (name.endsWith(".bin") && names.contains(name + "z")) {
+            continue;
+        }
+        result.append(dir.filePath(name));
+    }
+    return result;
+}
+
+bool HistoryLog::isCompressed(const QString &segmentPath)
+{
+    return segmentPath.endsWith(".binz");
+}
+
+qint64 HistoryLog::indexedCount(const QString &logPath)
+{
+    const QFileInfo index(indexPath(logPath));
+    return index.exists() ? index.size() / qint64(sizeof(IndexEntry)) : -1;
+}
+
+bool HistoryLog::append(Kind kind, const DrawRecord &record, const QList<qint64> &numbers, const QString &logPath)
+{
+    return append(QList<Entry>{{kind, record, numbers}}, false, logPath);
+}
+
+bool HistoryLog::append(const QList<Entry> &entries, bool sync, const QString &logPath)
+{
+    if (entries.isEmpty()) {
+        return true;
+    }
+    QLockFile lock(lockPath(logPath));
+    if (!lockLog(lock) || !repairLocked(logPath)) {
+        return false;
+    }
+
+    QFile log(logPath);
+    if (!log.open(QIODevice::Append)) {
+        return false;
+    }
+
+    std::vector<IndexEntry> indexEntries;
+    indexEntries.reserve(size_t(entries.size()));
+    bool ok = true;
+    for (const Entry &entry : entries) {
+        indexEntries.push_back({entry.record.time.toMSecsSinceEpoch(), quint64(log.pos())});
+        if (!(ok = writeEntry(log, entry))) {
+            break;
+        }
+    }
+    ok = ok && log.flush() && (!sync || syncFile(log));
+    log.close();
+    if (!ok) {
+        return false;
+    }
+
+    // 索引在记录写完之后追加；中途中断时由 repair() 按日志补齐
+    QFile index(indexPath(logPath));
+    if (!index.open(QIODevice::Append)) {
+        return false;
+    }
+    const qint64 indexSize = qint64(indexEntries.size() * sizeof(IndexEntry));
+    return index.write(reinterpret_cast<const char *>(indexEntries.data()), indexSize) == indexSize
+           && index.flush() && (!sync || syncFile(index));
+}
+
+bool HistoryLog::writeEntry(QFile &log, const Entry &entry)
+{
+    const DrawRecord &record = entry.record;
+
+    // 数字以相对最小值的偏移做变长编码；其他记录的负载为输出文件路径，批量记录在路径前加 8 字节的抽取次数
+    const QByteArray path = record.outputPath.toUtf8();
+    quint64 payloadSize = 0;
+    if (entry.kind == Kind::Numbers) {
+        for (qint64 number : entry.numbers) {
+            payloadSize += varintSize(quint64(number) - quint64(record.min));
+        }
+    } else {
+        payloadSize = quint64(path.size()) + (entry.kind == Kind::Batch ? sizeof(qint64) : 0);
+    }
+
+    const RecordHeader header{Magic,
+                              FormatVersion,
+                              quint8(entry.kind),
+                              quint8(record.unique ? UniqueFlag : 0),
+                              record.time.toMSecsSinceEpoch(),
+                              record.min,
+                              record.max,
+                              record.count,
+                              record.seed,
+                              record.exclusionHash,
+                              quint32(record.engine),
+                              quint32(HistoryFile::SeedRecordVersion),
+                              payloadSize};
+
+    if (log.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))) {
+        return false;
+    }
+    if (entry.kind == Kind::Batch
+        && log.write(reinterpret_cast<const char *>(&record.draws), sizeof(qint64)) != qint64(sizeof(qint64))) {
+        return false;
+    }
+    if (entry.kind != Kind::Numbers) {
+        return log.write(path) == path.size();
+    }
+
+    // 分块编码写入，不为整个负载分配内存
+    std::vector<char> buffer(size_t(std::min<quint64>(payloadSize, kEncodeBufferSize)) + 10);
+    char *cursor = buffer.data();
+    for (qint64 number : entry.numbers) {
+        cursor = writeVarint(cursor, quint64(number) - quint64(record.min));
+        if (cursor - buffer.data() >= kEncodeBufferSize) {
+            if (log.write(buffer.data(), cursor - buffer.data()) != cursor - buffer.data()) {
+                return false;
+            }
+            cursor = buffer.data();
+        }
+    }
+    return log.write(buffer.data(), cursor - buffer.data()) == cursor - buffer.data();
+}
+
+bool HistoryLog::syncFile(QFile &file)
+{
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+void HistoryLog::maintain(const Retention &retention, const QString &logPath, bool onlyAfterRotate)
+{
+    QLockFile lock(lockPath(logPath));
+    if (!lockLog(lock)) {
+        return;
+    }
+    if (!rotate(retention, logPath) && onlyAfterRotate) {
+        return;
+    }
+
+    QStringList closed = segments(logPath);
+    if (retention.compress) {
+        for (QString &segment : closed) {
+            if (!isCompressed(segment) && compressSegment(segment)) {
+                segment += "z";
+            }
+        }
+    }
+
+    // 从最新的分段往前累计大小；时间按索引文件的修改时间，即分段最后一条记录的写入时间
+    const QDateTime cutoff = QDateTime::currentDateTime().addDays(-retention.retentionDays);
+    qint64 total = 0;
+    for (qsizetype i = closed.size() - 1; i >= 0; --i) {
+        const QFileInfo segment(closed[i]);
+        const QFileInfo index(indexPath(closed[i]));
+        total += segment.size() + index.size();
+
+        const QDateTime closedTime = index.exists() ? index.lastModified() : segment.lastModified();
+        if ((retention.retentionSize > 0 && total > retention.retentionSize)
+            || (retention.retentionDays > 0 && closedTime < cutoff)) {
+            QFile::remove(closed[i]);
+            QFile::remove(index.filePath());
+        }
+    }
+}
+
+bool HistoryLog::rotate(const Retention &retention, const QString &logPath)
+{
+    QFile log(logPath);
+    if (!log.open(QIODevice::ReadOnly) || log.size() == 0) {
+        return false;
+    }
+
+    RecordHeader first;
+    if (log.read(reinterpret_cast<char *>(&first), sizeof(first)) != qint64(sizeof(first)) || first.magic != Magic) {
+        return false;
+    }
+    const qint64 sizeLimit = retention.segmentSize > 0 ? std::min(retention.segmentSize, MaxSegmentSize)
+                                                       : MaxSegmentSize;
+    const bool full = log.size() >= sizeLimit;
+    const bool expired = retention.segmentDays > 0
+                         && first.time < QDateTime::currentDateTime().addDays(-retention.segmentDays).toMSecsSinceEpoch();
+    log.close();
+    if (!full && !expired) {
+        return false;
+    }
+
+    if (!repairLocked(logPath)) {
+        return false;
+    }
+
+    const QFileInfo info(logPath);
+    const QString stem = info.dir().filePath(QString("%1-%2").arg(
+        info.completeBaseName(), QDateTime::fromMSecsSinceEpoch(first.time).toString("yyyyMMdd-hhmmsszzz")));
+    QString segment = stem + ".bin";
+    for (int i = 1; QFile::exists(segment) || QFile::exists(segment + "z"); ++i) {
+        segment = QString("%1-%2.bin").arg(stem).arg(i);
+    }
+
+    // 先移走日志；索引移动失败时新日志为空，下次追加前 repair() 会清空旧索引，分段读取时改为扫描
+    if (!QFile::rename(logPath, segment)) {
+        return false;
+    }
+    QFile::rename(indexPath(logPath), indexPath(segment));
+    return true;
+}
+
+bool HistoryLog::compressSegment(const QString &segmentPath)
+{
+    QFile segment(segmentPath);
+    if (!segment.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray compressed = qCompress(segment.readAll());
+    segment.close();
+
+    QSaveFile file(segmentPath + "z");
+    if (compressed.isEmpty() || !file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (file.write(compressed) != compressed.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit() && QFile::remove(segmentPath);
+}
+
+bool HistoryLog::exportText(const QString &textPath, const QString &logPath)
+{
+    QSaveFile file(textPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    QStringList paths = segments(logPath);
+    paths.append(logPath);
+    for (const QString &path : paths) {
+        exportReader(out, HistoryLogReader(path));
+    }
+    out.flush();
+    return file.commit();
+}
+
+void HistoryLog::exportReader(QTextStream &out, const HistoryLogReader &reader)
+{
+    for (qint64 i = 0; i < reader.recordCount(); ++i) {
+        const DrawRecord record = reader.record(i);
+        switch (reader.kind(i)) {
+        case Kind::Numbers:
+            HistoryFile::writeNumbersRecord(out, record, reader.numbers(i));
+            break;
+        case Kind::Stream:
+        case Kind::Batch:
+            HistoryFile::writeStreamRecord(out, record);
+            break;
+        case Kind::Seed:
+            HistoryFile::writeSeedRecord(out, record);
+            break;
+        }
+    }
+}
+
+bool HistoryLog::repair(const QString &logPath)
+{
+    QLockFile lock(lockPath(logPath));
+    return lockLog(lock) && repairLocked(logPath);
+}
+
+bool HistoryLog::repairLocked(const QString &logPath)
+{
+    QFile log(logPath);
+    QFile index(indexPath(logPath));
+    if (!log.exists()) {
+        // 没有日志时索引也应为空
+        return !index.exists() || index.size() == 0 || index.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!log.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    const qint64 logSize = log.size();
+
+    // 快速检查：索引的最后一项指向的记录恰好在日志末尾结束
+    if (index.open(QIODevice::ReadOnly) && index.size() % qint64(sizeof(IndexEntry)) == 0) {
+        if (index.size() == 0 && logSize == 0) {
+            return true;
+        }
+        IndexEntry last;
+        RecordHeader header;
+        if (index.size() > 0 && index.seek(index.size() - qint64(sizeof(IndexEntry)))
+            && index.read(reinterpret_cast<char *>(&last), sizeof(last)) == qint64(sizeof(last))
+            && last.offset + sizeof(RecordHeader) <= quint64(logSize) && log.seek(qint64(last.offset))
+            && log.read(reinterpret_cast<char *>(&header), sizeof(header)) == qint64(sizeof(header))
+            && header.magic == Magic && header.version == FormatVersion
+            && last.offset + sizeof(RecordHeader) + header.payloadSize == quint64(logSize)) {
+            return true;
+        }
+    }
+    index.close();
+
+    // 扫描日志重建索引，并截掉末尾写了一半的记录
+    std::vector<IndexEntry> entries;
+    qint64 end = 0;
+    if (logSize > 0) {
+        uchar *data = log.map(0, logSize);
+        if (!data) {
+            return false;
+        }
+        end = scan(data, logSize, &entries);
+        log.unmap(data);
+    }
+    if (end < logSize && !log.resize(end)) {
+        return false;
+    }
+    log.close();
+
+    QSaveFile newIndex(indexPath(logPath));
+    if (!newIndex.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const qint64 indexSize = qint64(entries.size() * sizeof(IndexEntry));
+    if (newIndex.write(reinterpret_cast<const char *>(entries.data()), indexSize) != indexSize) {
+        newIndex.cancelWriting();
+        return false;
+    }
+    return newIndex.commit();
+}
+
+qint64 HistoryLog::scan(const uchar *data, qint64 size, std::vector<IndexEntry> *entries)
+{
+    quint64 offset = 0;
+    RecordHeader header;
+    while (readHeader(data, size, offset, &header)) {
+        entries->push_back({header.time, offset});
+        offset += sizeof(RecordHeader) + header.payloadSize;
+    }
+    return qint64(offset);
+}
+
+bool HistoryLog::readHeader(const uchar *data, qint64 size, quint64 offset, RecordHeader *header)
+{
+    static_assert(sizeof(RecordHeader) == 72, "头部布局是文件格式的一部分");
+    static_assert(sizeof(IndexEntry) == 16, "索引项布局是文件格式的一部分");
+
+    if (offset + sizeof(RecordHeader) > quint64(size)) {
+        return false;
+    }
+    // 记录不按 8 字节对齐，复制出来再读
+    std::memcpy(header, data + offset, sizeof(RecordHeader));
+    return header->magic == Magic && header->version == FormatVersion
+           && header->payloadSize <= quint64(size) - offset - sizeof(RecordHeader);
+}
+
+HistoryLogReader::HistoryLogReader(const QString &logPath)
+    : m_logFile(logPath), m_indexFile(HistoryLog::indexPath(logPath))
+{
+    if (!m_logFile.open(QIODevice::ReadOnly) || m_logFile.size() == 0) {
+        return;
+    }
+    if (HistoryLog::isCompressed(logPath)) {
+        m_uncompressed = qUncompress(m_logFile.readAll());
+        m_logFile.close();
+        m_log = reinterpret_cast<const uchar *>(m_uncompressed.constData());
+        m_logSize = m_uncompressed.size();
+    } else {
+        m_logSize = m_logFile.size();
+        m_log = m_logFile.map(0, m_logSize);
+    }
+    if (!m_log || m_logSize == 0) {
+        m_log = nullptr;
+        m_logSize = 0;
+        return;
+    }
+
+    // 索引最后一项指向的记录应恰好在日志末尾结束，否则不使用索引，改为扫描日志
+    const qint64 indexSize = m_indexFile.open(QIODevice::ReadOnly) ? m_indexFile.size() : 0;
+    if (indexSize > 0 && indexSize % qint64(sizeof(HistoryLog::IndexEntry)) == 0) {
+        m_index = m_indexFile.map(0, indexSize);
+        if (m_index) {
+            m_count = indexSize / qint64(sizeof(HistoryLog::IndexEntry));
+            HistoryLog::RecordHeader last;
+            const HistoryLog::IndexEntry lastEntry = entry(m_count - 1);
+            if (HistoryLog::readHeader(m_log, m_logSize, lastEntry.offset, &last)
+                && lastEntry.offset + sizeof(last) + last.payloadSize == quint64(m_logSize)) {
+                return;
+            }
+            m_index = nullptr;
+        }
+    }
+
+    m_scanned.clear();
+    HistoryLog::scan(m_log, m_logSize, &m_scanned);
+    m_count = qint64(m_scanned.size());
+}
+
+HistoryLog::IndexEntry HistoryLogReader::entry(qint64 index) const
+{
+    if (!m_index) {
+        return m_scanned[size_t(index)];
+    }
+    HistoryLog::IndexEntry result;
+    std::memcpy(&result, m_index + index * qint64(sizeof(result)), sizeof(result));
+    return result;
+}
+
+HistoryLog::RecordHeader HistoryLogReader::header(qint64 index) const
+{
+    HistoryLog::RecordHeader result{};
+    HistoryLog::readHeader(m_log, m_logSize, entry(index).offset, &result);
+    return result;
+}
+
+HistoryLog::Kind HistoryLogReader::kind(qint64 index) const
+{
+    return HistoryLog::Kind(header(index).kind);
+}
+
+bool HistoryLogReader::isReplayable(qint64 index) const
+{
+    const HistoryLog::RecordHeader h = header(index);
+    return HistoryLog::Kind(h.kind) == HistoryLog::Kind::Seed && h.algorithmVersion == HistoryFile::SeedRecordVersion;
+}
+
+DrawRecord HistoryLogReader::record(qint64 index) const
+{
+    const quint64 offset = entry(index).offset;
+    const HistoryLog::RecordHeader h = header(index);
+
+    DrawRecord record;
+    record.time = QDateTime::fromMSecsSinceEpoch(h.time);
+    record.min = h.min;
+    record.max = h.max;
+    record.count = h.count;
+    record.unique = h.flags & HistoryLog::UniqueFlag;
+    record.engine = EngineType(h.engine);
+    record.seed = h.seed;
+    record.exclusionHash = h.exclusionHash;
+    const uchar *payload = m_log + offset + sizeof(h);
+    quint64 pathSize = h.payloadSize;
+    if (HistoryLog::Kind(h.kind) == HistoryLog::Kind::Batch && pathSize >= sizeof(qint64)) {
+        std::memcpy(&record.draws, payload, sizeof(qint64));
+        payload += sizeof(qint64);
+        pathSize -= sizeof(qint64);
+    }
+    if (HistoryLog::Kind(h.kind) != HistoryLog::Kind::Numbers) {
+        record.outputPath = QString::fromUtf8(reinterpret_cast<const char *>(payload), qsizetype(pathSize));
+    }
+    return record;
+}
+
+QList<qint64> HistoryLogReader::numbers(qint64 index) const
+{
+    const quint64 offset = entry(index).offset;
+    const HistoryLog::RecordHeader h = header(index);
+    if (HistoryLog::Kind(h.kind) != HistoryLog::Kind::Numbers) {
+        return {};
+    }
+
+    QList<qint64> result;
+    result.reserve(h.count);
+    const uchar *in = m_log + offset + sizeof(h);
+    const uchar *end = in + h.payloadSize;
+    quint64 value;
+    while (result.size() < h.count && readVarint(in, end, &value)) {
+        result.append(qint64(quint64(h.min) + value));
+    }
+    return result;
+}
@@ -0,0 +1,157 @@
+// HistoryLog.h
+#ifndef HISTORYLOG_H
+#define HISTORYLOG_H
+
+#include <QFile>
+#include <QList>
+#include <QStringList>
+#include <QString>
+#include <vector>
+#include "HistoryFile.h"
+
+class HistoryLogReader;
+
+// 二进制追加式历史日志
+// history.bin 依次保存记录：定长头部(时间、范围、数量、种子、排除集合哈希等) + 负载，
+// 数字记录的负载为 (数字 - 最小值) 的变长编码，范围较小时每个数字只占 1~2 字节；
+// history.idx 为每条记录保存 (时间, 偏移)，可按序号直接定位，不需要解析整个文件。
+// 排除集合按哈希单独保存(见 HistoryFile::storeExclusionSet)。
+// 当前日志超过大小或时间限制后关闭为分段 history-<首条记录时间>.bin(压缩后为 .binz)，
+// 分段的索引保持不压缩，按保留策略删除旧分段。
+// 多个进程可以写同一个日志：追加、修复和分段维护都在 history.bin.lock 锁文件的保护下进行。
+class HistoryLog
+{
+public:
+    enum class Kind : quint8 {
+        Numbers = 1, // 保存全部数字
+        Stream = 2,  // 流式生成，只保存输出文件位置
+        Seed = 3,    // 可复现模式，只保存种子
+        Batch = 4    // 批量抽取到文件，负载为抽取次数和输出文件位置
+    };
+
+    // 一条待写入的记录，numbers 只用于 Numbers 记录
+    struct Entry
+    {
+        Kind kind = Kind::Numbers;
+        DrawRecord record;
+        QList<qint64> numbers;
+    };
+
+    // 分段和保留策略，0 表示不限制
+    struct Retention
+    {
+        qint64 segmentSize = 64LL * 1024 * 1024; // 当前日志达到该字节数后关闭为分段
+        int segmentDays = 0;                     // 当前日志第一条记录超过该天数后关闭为分段
+        bool compress = true;                    // 用 qCompress 压缩关闭的分段
+        int retentionDays = 0;                   // 删除最后修改时间超过该天数的分段
+        qint64 retentionSize = 1024LL * 1024 * 1024; // 分段总大小超过该字节数时从最旧的开始删除
+    };
+
+    // 分段不超过该大小，qCompress 一次处理整个分段
+    static constexpr qint64 MaxSegmentSize = 1024LL * 1024 * 1024;
+
+    static QString defaultPath();
+    static QString indexPath(const QString &logPath);
+    static QString lockPath(const QString &logPath);
+    // 已关闭的分段，从旧到新
+    static QStringList segments(const QString &logPath = defaultPath());
+    static bool isCompressed(const QString &segmentPath);
+    // 按索引文件大小得到的记录数，没有索引时返回 -1
+    static qint64 indexedCount(const QString &logPath);
+
+    // 追加一条记录
+    static bool append(Kind kind, const DrawRecord &record, const QList<qint64> &numbers = {},
+                       const QString &logPath = defaultPath());
+    // 一次打开文件追加多条记录；sync 为 true 时返回前把日志和索引写入磁盘(fsync)
+    static bool append(const QList<Entry> &entries, bool sync = false, const QString &logPath = defaultPath());
+
+    // 按保留策略关闭当前日志、压缩并删除旧分段，在后台线程中调用；
+    // onlyAfterRotate 为 true 时只在这次确实关闭了当前日志后才压缩和删除分段，不需要关闭时几乎不花时间
+    static void maintain(const Retention &retention, const QString &logPath = defaultPath(),
+                         bool onlyAfterRotate = false);
+
+    // 按原来的文本格式导出全部分段和当前日志的记录
+    static bool exportText(const QString &textPath, const QString &logPath = defaultPath());
+
+    // 截掉日志末尾不完整的记录，并在索引与日志不一致时按日志重建索引
+    static bool repair(const QString &logPath = defaultPath());
+
+private:
+    friend class HistoryLogReader;
+
+    // 按自然对齐排列，没有填充；文件中为小端序
+    struct RecordHeader
+    {
+        quint32 magic;
+        quint16 version;
+        quint8 kind;
+        quint8 flags;
+        qint64 time; // 自 1970 年起的毫秒数
+        qint64 min;
+        qint64 max;
+        qint64 count;
+        quint64 seed;
+        quint64 exclusionHash;
+        quint32 engine;
+        quint32 algorithmVersion;
+        quint64 payloadSize;
+    };
+
+    struct IndexEntry
+    {
+        qint64 time;
+        quint64 offset;
+    };
+
+    static constexpr quint32 Magic = 0x48474E52; // "RNGH"
+    static constexpr quint16 FormatVersion = 1;
+    static constexpr quint8 UniqueFlag = 0x01;
+
+    // 调用方已持有 lockPath() 的锁
+    static bool repairLocked(const QString &logPath);
+    // 返回是否把当前日志关闭为分段
+    static bool rotate(const Retention &retention, const QString &logPath);
+    static bool compressSegment(const QString &segmentPath);
+
+    static bool writeEntry(QFile &log, const Entry &entry);
+    static void exportReader(QTextStream &out, const HistoryLogReader &reader);
+    static bool syncFile(QFile &file);
+
+    // 从头扫描日志，返回最后一条完整记录的结束位置
+    static qint64 scan(const uchar *data, qint64 size, std::vector<IndexEntry> *entries);
+    static bool readHeader(const uchar *data, qint64 size, quint64 offset, RecordHeader *header);
+};
+
+// 历史日志的只读访问
+// 日志和索引都以内存映射方式打开，按序号随机访问，只解码被访问的记录；
+// 压缩的分段整体解压到内存中读取。
+class HistoryLogReader
+{
+public:
+    explicit HistoryLogReader(const QString &logPath = HistoryLog::defaultPath());
+
+    qint64 recordCount() const { return m_count; }
+
+    HistoryLog::Kind kind(qint64 index) const;
+    // 算法版本一致的种子记录才能按种子重新生成
+    bool isReplayable(qint64 index) const;
+    // 记录参数(排除集合只有哈希)
+    DrawRecord record(qint64 index) const;
+    // Numbers 记录中保存的数字
+    QList<qint64> numbers(qint64 index) const;
+
+private:
+    HistoryLog::IndexEntry entry(qint64 index) const;
+    HistoryLog::RecordHeader header(qint64 index) const;
+
+    QFile m_logFile;
+    QFile m_indexFile;
+    QByteArray m_uncompressed;
+    const uchar *m_log = nullptr;
+    qint64 m_logSize = 0;
+    const uchar *m_index = nullptr;
+    std::vector<HistoryLog::IndexEntry> m_scanned; // 索引文件与日志不一致时扫描日志得到
+    qint64 m_count = 0;
+};
+
+#endif // HISTORYLOG_H
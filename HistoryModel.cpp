@@ -0,0 +1,152 @@
+// HistoryModel.cpp
+#include "HistoryModel.h"
+#include <algorithm>
+#include <limits>
+
+HistoryModel::HistoryModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void HistoryModel::reload()
+{
+    beginResetModel();
+    m_cached.reset();
+    m_current = std::make_unique<HistoryLogReader>();
+    m_segments.clear();
+    m_segments.push_back({HistoryLog::defaultPath(), 0, m_current->recordCount()});
+
+    const QStringList closed = HistoryLog::segments();
+    for (qsizetype i = closed.size() - 1; i >= 0; --i) {
+        // 分段关闭前已经修复过，索引项数即记录数；没有索引时只能打开分段计数
+        qint64 count = HistoryLog::indexedCount(closed[i]);
+        if (count < 0) {
+            count = HistoryLogReader(closed[i]).recordCount();
+        }
+        m_segments.push_back({closed[i], 0, count});
+    }
+
+    m_rowCount = 0;
+    for (Segment &segment : m_segments) {
+        segment.firstRow = m_rowCount;
+        m_rowCount += segment.count;
+    }
+    endResetModel();
+}
+
+void HistoryModel::clear()
+{
+    beginResetModel();
+    m_cached.reset();
+    m_current.reset();
+    m_segments.clear();
+    m_rowCount = 0;
+    endResetModel();
+}
+
+const HistoryLogReader *HistoryModel::locate(int row, qint64 *index) const
+{
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), qint64(row),
+                               [](qint64 value, const Segment &segment) { return value < segment.firstRow; });
+    if (row < 0 || it == m_segments.begin()) {
+        return nullptr;
+    }
+    const size_t segment = size_t(it - m_segments.begin()) - 1;
+
+    const HistoryLogReader *reader = m_current.get();
+    if (segment > 0) {
+        if (!m_cached || m_cachedSegment != segment) {
+            m_cached = std::make_unique<HistoryLogReader>(m_segments[segment].path);
+            m_cachedSegment = segment;
+        }
+        reader = m_cached.get();
+    }
+
+    // 索引与分段不一致时读取器按扫描结果计数，可能比列出的行少
+    *index = m_segments[segment].count - 1 - (row - m_segments[segment].firstRow);
+    return reader && *index >= 0 && *index < reader->recordCount() ? reader : nullptr;
+}
+
+HistoryLog::Kind HistoryModel::kind(int row) const
+{
+    qint64 index;
+    const HistoryLogReader *reader = locate(row, &index);
+    return reader ? reader->kind(index) : HistoryLog::Kind::Stream;
+}
+
+bool HistoryModel::isReplayable(int row) const
+{
+    qint64 index;
+    const HistoryLogReader *reader = locate(row, &index);
+    return reader && reader->isReplayable(index);
+}
+
+DrawRecord HistoryModel::record(int row) const
+{
+    qint64 index;
+    const HistoryLogReader *reader = locate(row, &index);
+    return reader ? reader->record(index) : DrawRecord();
+}
+
+QList<qint64> HistoryModel::numbers(int row) const
+{
+    qint64 index;
+    const HistoryLogReader *reader = locate(row, &index);
+    return reader ? reader->numbers(index) : QList<qint64>();
+}
+
+int HistoryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return int(std::min<qint64>(m_rowCount, std::numeric_limits<int>::max()));
+}
+
+QVariant HistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::ToolTipRole)) {
+        return QVariant();
+    }
+
+    qint64 position;
+    const HistoryLogReader *reader = locate(index.row(), &position);
+    if (!reader) {
+        return QVariant();
+    }
+    const DrawRecord record = reader->record(position);
+
+    if (role == Qt::ToolTipRole) {
+        return record.outputPath.isEmpty() ? QVariant() : QVariant(QString("输出文件: %1").arg(record.outputPath));
+    }
+
+    QString kind;
+    switch (reader->kind(position)) {
+    case HistoryLog::Kind::Numbers:
+        kind = "数字";
+        break;
+    case HistoryLog::Kind::Stream:
+        kind = "文件";
+        break;
+    case HistoryLog::Kind::Seed:
+        kind = "种子";
+        break;
+    case HistoryLog::Kind::Batch:
+        kind = "批量";
+        break;
+    }
+
+    QString text = QString("%1  [%2]  范围: %3 - %4  数量: %5%6")
+                       .arg(record.time.toString("yyyy-MM-dd hh:mm:ss"))
+                       .arg(kind)
+                       .arg(record.min)
+                       .arg(record.max)
+                       .arg(record.count)
+                       .arg(record.unique ? "" : "(可重复)");
+    if (reader->kind(position) == HistoryLog::Kind::Seed) {
+        text += QString("  种子: %1").arg(record.seed);
+    } else if (reader->kind(position) == HistoryLog::Kind::Batch) {
+        text += QString("  × %1 次").arg(record.draws);
+    }
+    return text;
+}
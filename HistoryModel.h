@@ -0,0 +1,51 @@
+// HistoryModel.h
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <memory>
+#include <vector>
+#include "HistoryLog.h"
+
+// 历史记录列表的数据模型，最新的记录在最前面
+// 直接读取内存映射的历史日志，视图只会请求可见行，记录数量很大时也不需要预先加载。
+// 已关闭的分段按索引文件计数，只在被访问时打开(压缩的分段需要解压)，同时只保留一个。
+class HistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit HistoryModel(QObject *parent = nullptr);
+
+    // 重新列出分段并打开当前日志
+    void reload();
+    // 关闭所有文件，后台线程可以移动或删除分段
+    void clear();
+
+    HistoryLog::Kind kind(int row) const;
+    bool isReplayable(int row) const;
+    DrawRecord record(int row) const;
+    QList<qint64> numbers(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Segment
+    {
+        QString path;
+        qint64 firstRow = 0; // 该分段最新一条记录所在的行
+        qint64 count = 0;
+    };
+
+    // 行对应的读取器和分段内的记录序号，记录不存在时返回空
+    const HistoryLogReader *locate(int row, qint64 *index) const;
+
+    std::vector<Segment> m_segments; // 从新到旧，第一个为当前日志
+    qint64 m_rowCount = 0;
+    std::unique_ptr<HistoryLogReader> m_current;
+    mutable std::unique_ptr<HistoryLogReader> m_cached;
+    mutable size_t m_cachedSegment = 0;
+};
+
+#endif // HISTORYMODEL_H
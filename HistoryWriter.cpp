@@ -0,0 +1,158 @@
+// HistoryWriter.cpp
+#include "HistoryWriter.h"
+#include <QDeadlineTimer>
+#include <algorithm>
+
+HistoryWriter::HistoryWriter(Options options, QObject *parent)
+    : QObject(parent), m_options(std::move(options))
+{
+    m_options.queueCapacity = std::max(1, m_options.queueCapacity);
+    m_options.queueValueCapacity = std::max<qint64>(1, m_options.queueValueCapacity);
+    m_options.flushInterval = std::max(0, m_options.flushInterval);
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start(QThread::LowPriority);
+}
+
+HistoryWriter::~HistoryWriter()
+{
+    close();
+    delete m_thread;
+}
+
+void HistoryWriter::enqueue(HistoryLog::Entry entry)
+{
+    const qint64 values = entry.numbers.size();
+    QMutexLocker locker(&m_mutex);
+    // 队列为空时总能放入，数字很多的单条记录不会一直等待
+    while (!m_queue.isEmpty() && !m_stopping
+           && (m_queue.size() >= m_options.queueCapacity
+               || m_queuedValues + values > m_options.queueValueCapacity)) {
+        m_queueNotFull.wait(&m_mutex);
+    }
+    if (m_stopping) {
+        return;
+    }
+
+    m_queue.append(std::move(entry));
+    m_queuedValues += values;
+    ++m_enqueued;
+    m_queueChanged.wakeOne();
+}
+
+void HistoryWriter::waitForWritten()
+{
+    QMutexLocker locker(&m_mutex);
+    const qint64 target = m_enqueued;
+    ++m_waiters;
+    m_queueChanged.wakeOne();
+    while (m_written < target && m_thread->isRunning()) {
+        m_batchWritten.wait(&m_mutex, QDeadlineTimer(100));
+    }
+    --m_waiters;
+}
+
+void HistoryWriter::close()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_queueChanged.wakeOne();
+        m_queueNotFull.wakeAll();
+    }
+    m_thread->wait();
+}
+
+QString HistoryWriter::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+void HistoryWriter::run()
+{
+    if (m_options.maintainOnStart) {
+        HistoryLog::maintain(m_options.retention, m_options.logPath);
+    }
+
+    for (;;) {
+        QList<HistoryLog::Entry> batch;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.isEmpty() && !m_stopping) {
+                m_queueChanged.wait(&m_mutex);
+            }
+            if (m_queue.isEmpty()) {
+                break; // 已要求停止且队列已写完
+            }
+
+            // 等待一小段时间，把连续生成的记录合并成一次写入
+            QDeadlineTimer deadline(m_options.flushInterval);
+            while (!m_stopping && m_waiters == 0 && m_queue.size() < m_options.queueCapacity
+                   && m_queuedValues < m_options.queueValueCapacity && !deadline.hasExpired()) {
+                m_queueChanged.wait(&m_mutex, deadline);
+            }
+
+            batch.swap(m_queue);
+            m_queuedValues = 0;
+            m_queueNotFull.wakeAll();
+        }
+
+        // 排除集合文件必须先于引用它的记录写入
+        bool stored = true;
+        for (const HistoryLog::Entry &entry : batch) {
+            stored = HistoryFile::storeExclusionSet(entry.record.excluded) && stored;
+        }
+        const bool appended = HistoryLog::append(batch, m_options.flushPolicy == FlushPolicy::Sync, m_options.logPath);
+        HistoryLog::maintain(m_options.retention, m_options.logPath, true);
+
+        QMutexLocker locker(&m_mutex);
+        if (m_errorString.isEmpty() && !appended) {
+            m_errorString = QString("无法写入历史记录 %1").arg(m_options.logPath);
+        } else if (m_errorString.isEmpty() && !stored) {
+            m_errorString = "无法保存历史记录的排除数字文件";
+        }
+        m_written += batch.size();
+        m_batchWritten.wakeAll();
+    }
+}
+
+QString HistoryWriter::flushPolicyName(FlushPolicy policy)
+{
+    return policy == FlushPolicy::Sync ? "sync" : "flush";
+}
+
+HistoryWriter::FlushPolicy HistoryWriter::flushPolicyFromName(const QString &name)
+{
+    return name == "sync" ? FlushPolicy::Sync : FlushPolicy::Flush;
+}
+
+HistoryWriter::Options HistoryWriter::readOptions(const QSettings &settings)
+{
+    Options options;
+    options.flushPolicy = flushPolicyFromName(settings.value("History/flushPolicy").toString());
+    options.flushInterval = settings.value("History/flushInterval", 200).toInt();
+    options.queueCapacity = settings.value("History/queueCapacity", 64).toInt();
+    options.queueValueCapacity = settings.value("History/queueValueCapacity", 16 * 1024 * 1024).toLongLong();
+
+    HistoryLog::Retention &retention = options.retention;
+    retention.segmentSize = settings.value("History/segmentSizeMB", 64).toLongLong() * 1024 * 1024;
+    retention.segmentDays = settings.value("History/segmentDays", 0).toInt();
+    retention.compress = settings.value("History/compress", true).toBool();
+    retention.retentionDays = settings.value("History/retentionDays", 0).toInt();
+    retention.retentionSize = settings.value("History/retentionSizeMB", 1024).toLongLong() * 1024 * 1024;
+    return options;
+}
+
+void HistoryWriter::writeOptions(QSettings &settings, const Options &options)
+{
+    settings.setValue("History/flushPolicy", flushPolicyName(options.flushPolicy));
+    settings.setValue("History/flushInterval", options.flushInterval);
+    settings.setValue("History/queueCapacity", options.queueCapacity);
+    settings.setValue("History/queueValueCapacity", options.queueValueCapacity);
+    settings.setValue("History/segmentSizeMB", options.retention.segmentSize / (1024 * 1024));
+    settings.setValue("History/segmentDays", options.retention.segmentDays);
+    settings.setValue("History/compress", options.retention.compress);
+    settings.setValue("History/retentionDays", options.retention.retentionDays);
+    settings.setValue("History/retentionSizeMB", options.retention.retentionSize / (1024 * 1024));
+}
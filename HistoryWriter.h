@@ -0,0 +1,79 @@
+// HistoryWriter.h
+#ifndef HISTORYWRITER_H
+#define HISTORYWRITER_H
+
+#include <QMutex>
+#include <QObject>
+#include <QSettings>
+#include <QThread>
+#include <QWaitCondition>
+#include "HistoryLog.h"
+
+// 后台历史记录写入线程
+// 生成任务只把记录放入有界队列；写入线程把一段时间内积累的记录合并成一次追加，
+// 并按设置决定每批写完后是否 fsync。队列按记录数和数字总数限制，满时 enqueue() 阻塞调用的工作线程，
+// 界面线程不会写磁盘。写入失败不会中断生成，由 errorString() 报告。
+// 启动时在同一线程中关闭、压缩和清理历史分段；每批写完后只在当前日志需要关闭为分段时才整理。
+class HistoryWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class FlushPolicy {
+        Flush, // 每批写完交给操作系统
+        Sync   // 每批写完等待写入磁盘(fsync)
+    };
+
+    struct Options
+    {
+        FlushPolicy flushPolicy = FlushPolicy::Flush;
+        int flushInterval = 200; // 毫秒，收到记录后最多等待该时间以合并后续记录
+        int queueCapacity = 64;  // 队列中最多等待的记录数
+        qint64 queueValueCapacity = 16 * 1024 * 1024; // 队列中所有记录的数字总数上限，超过上限的单条记录单独排队
+        HistoryLog::Retention retention; // 分段、压缩和保留策略，每批写完后执行
+        bool maintainOnStart = true; // 启动时整理全部分段；只运行一次的命令行工具不需要
+        QString logPath = HistoryLog::defaultPath();
+    };
+
+    explicit HistoryWriter(Options options, QObject *parent = nullptr);
+    // 写完队列中剩余的记录后退出
+    ~HistoryWriter();
+
+    const Options &options() const { return m_options; }
+
+    // 放入一条记录，队列已满时等待；close() 之后的记录被丢弃
+    void enqueue(HistoryLog::Entry entry);
+    // 等待已放入的记录全部写完
+    void waitForWritten();
+    // 写完剩余记录并停止写入线程
+    void close();
+    // 第一次写入失败的原因，全部写入成功时为空
+    QString errorString() const;
+
+    static QString flushPolicyName(FlushPolicy policy);
+    static FlushPolicy flushPolicyFromName(const QString &name);
+
+    // 配置文件 History 组中的写入方式和分段保留策略，大小以 MB 为单位，0 表示不限制
+    static Options readOptions(const QSettings &settings);
+    static void writeOptions(QSettings &settings, const Options &options);
+
+private:
+    void run();
+
+    Options m_options;
+    QThread *m_thread;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_queueChanged;  // 有新记录、要求立即写入或停止
+    QWaitCondition m_queueNotFull;  // 写入线程取走了队列中的记录
+    QWaitCondition m_batchWritten;  // 一批记录写完
+    QList<HistoryLog::Entry> m_queue;
+    qint64 m_queuedValues = 0; // 队列中所有记录的数字总数
+    qint64 m_enqueued = 0;
+    qint64 m_written = 0;
+    int m_waiters = 0; // waitForWritten() 中等待的线程数，不为 0 时不再等待合并
+    bool m_stopping = false;
+    QString m_errorString;
+};
+
+#endif // HISTORYWRITER_H
@@ -0,0 +1,108 @@
+// Int64SpinBox.cpp
+#include "Int64SpinBox.h"
+#include <QLineEdit>
+#include <algorithm>
+
+Int64SpinBox::Int64SpinBox(QWidget *parent)
+    : QAbstractSpinBox(parent), m_minimum(0), m_maximum(99), m_value(0)
+{
+    updateText();
+
+    connect(lineEdit(), &QLineEdit::textEdited, this, &Int64SpinBox::onTextEdited);
+    connect(this, &QAbstractSpinBox::editingFinished, this, &Int64SpinBox::onEditingFinished);
+}
+
+void Int64SpinBox::setRange(qint64 minimum, qint64 maximum)
+{
+    m_minimum = minimum;
+    m_maximum = std::max(minimum, maximum);
+    setValue(m_value);
+}
+
+void Int64SpinBox::setValue(qint64 value)
+{
+    value = std::clamp(value, m_minimum, m_maximum);
+    if (value != m_value) {
+        m_value = value;
+        updateText();
+        emit valueChanged(m_value);
+    } else {
+        updateText();
+    }
+}
+
+void Int64SpinBox::stepBy(int steps)
+{
+    // 饱和加法，避免越过 qint64 边界
+    qint64 value = m_value;
+    if (steps > 0) {
+        value = (quint64(m_maximum) - quint64(value) < quint64(steps)) ? m_maximum : value + steps;
+    } else if (steps < 0) {
+        value = (quint64(value) - quint64(m_minimum) < quint64(-qint64(steps))) ? m_minimum : value + steps;
+    }
+    setValue(value);
+    selectAll();
+}
+
+QValidator::State Int64SpinBox::validate(QString &input, int &pos) const
+{
+    Q_UNUSED(pos);
+
+    const QString text = input.trimmed();
+    if (text.isEmpty() || text == "-" || text == "+") {
+        return QValidator::Intermediate;
+    }
+
+    bool ok;
+    qint64 value = text.toLongLong(&ok);
+    if (!ok) {
+        return QValidator::Invalid;
+    }
+
+    return (value >= m_minimum && value <= m_maximum) ? QValidator::Acceptable : QValidator::Intermediate;
+}
+
+void Int64SpinBox::fixup(QString &input) const
+{
+    bool ok;
+    qint64 value = input.trimmed().toLongLong(&ok);
+    input = QString::number(ok ? std::clamp(value, m_minimum, m_maximum) : m_value);
+}
+
+QAbstractSpinBox::StepEnabled Int64SpinBox::stepEnabled() const
+{
+    StepEnabled enabled = StepNone;
+    if (m_value > m_minimum) {
+        enabled |= StepDownEnabled;
+    }
+    if (m_value < m_maximum) {
+        enabled |= StepUpEnabled;
+    }
+    return enabled;
+}
+
+void Int64SpinBox::onTextEdited(const QString &text)
+{
+    // 与 QSpinBox 的键盘跟踪一致：输入合法时立即更新数值，但不改写正在输入的文本
+    bool ok;
+    qint64 value = text.trimmed().toLongLong(&ok);
+    if (ok && value >= m_minimum && value <= m_maximum && value != m_value) {
+        m_value = value;
+        emit valueChanged(m_value);
+    }
+}
+
+void Int64SpinBox::onEditingFinished()
+{
+    QString text = lineEdit()->text();
+    fixup(text);
+    setValue(text.toLongLong());
+}
+
+void Int64SpinBox::updateText()
+{
+    const QString text = QString::number(m_value);
+    if (lineEdit()->text() != text) {
+        lineEdit()->setText(text);
+    }
+}
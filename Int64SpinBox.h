@@ -0,0 +1,45 @@
+// Int64SpinBox.h
+#ifndef INT64SPINBOX_H
+#define INT64SPINBOX_H
+
+#include <QAbstractSpinBox>
+
+// 64 位整数输入框(QSpinBox 只支持 int 范围)
+class Int64SpinBox : public QAbstractSpinBox
+{
+    Q_OBJECT
+
+public:
+    explicit Int64SpinBox(QWidget *parent = nullptr);
+
+    qint64 value() const { return m_value; }
+    qint64 minimum() const { return m_minimum; }
+    qint64 maximum() const { return m_maximum; }
+    void setRange(qint64 minimum, qint64 maximum);
+
+    void stepBy(int steps) override;
+    QValidator::State validate(QString &input, int &pos) const override;
+    void fixup(QString &input) const override;
+
+public slots:
+    void setValue(qint64 value);
+
+signals:
+    void valueChanged(qint64 value);
+
+protected:
+    StepEnabled stepEnabled() const override;
+
+private slots:
+    void onTextEdited(const QString &text);
+    void onEditingFinished();
+
+private:
+    void updateText();
+
+    qint64 m_minimum;
+    qint64 m_maximum;
+    qint64 m_value;
+};
+
+#endif // INT64SPINBOX_H
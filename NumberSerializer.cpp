@@ -0,0 +1,119 @@
+// NumberSerializer.cpp
+#include "NumberSerializer.h"
+#include <algorithm>
+#include <charconv>
+
+NumberSerializer::NumberSerializer(Layout layout, qint64 total, qint64 valuesPerLine)
+    : m_layout(layout), m_total(total), m_valuesPerLine(valuesPerLine)
+{
+}
+
+char *NumberSerializer::serialize(const qint64 *values, qsizetype count, char *out)
+{
+    for (qsizetype i = 0; i < count; ++i, ++m_index) {
+        out = std::to_chars(out, out + MaxEntrySize, values[i]).ptr;
+
+        const bool last = m_index == m_total - 1;
+        const bool lineEnd = ++m_column == m_valuesPerLine;
+        if (lineEnd) {
+            m_column = 0;
+        }
+        switch (m_layout) {
+        case Layout::Grouped:
+            if (!last) {
+                *out++ = ',';
+                *out++ = ' ';
+            }
+            if (lineEnd) {
+                *out++ = '\n';
+            }
+            break;
+        case Layout::Csv:
+            *out++ = (last || lineEnd) ? '\n' : ',';
+            break;
+        case Layout::OnePerLine:
+            *out++ = '\n';
+            break;
+        }
+    }
+    return out;
+}
+
+bool NumberSerializer::write(QIODevice *device, const qint64 *values, qsizetype count)
+{
+    if (m_buffer.empty()) {
+        m_buffer.resize(BufferSize);
+    }
+
+    while (count > 0) {
+        const qsizetype room = (BufferSize - m_used) / MaxEntrySize;
+        if (room == 0) {
+            if (!flush(device)) {
+                return false;
+            }
+            continue;
+        }
+
+        const qsizetype n = std::min(count, room);
+        m_used = serialize(values, n, m_buffer.data() + m_used) - m_buffer.data();
+        values += n;
+        count -= n;
+    }
+    return true;
+}
+
+bool NumberSerializer::flush(QIODevice *device)
+{
+    if (m_used == 0) {
+        return true;
+    }
+
+    const bool ok = device->write(m_buffer.data(), m_used) == m_used;
+    m_used = 0;
+    return ok;
+}
+
+QByteArray NumberSerializer::toBytes(const QList<qint64> &numbers, Layout layout)
+{
+    // 先按最大长度分配，序列化后再截断
+    QByteArray bytes(numbers.size() * MaxEntrySize, Qt::Uninitialized);
+    NumberSerializer serializer(layout, numbers.size());
+    char *end = serializer.serialize(numbers.constData(), numbers.size(), bytes.data());
+    bytes.truncate(end - bytes.constData());
+    return bytes;
+}
+
+QString NumberSerializer::toString(const QList<qint64> &numbers, Layout layout)
+{
+    return QString::fromLatin1(toBytes(numbers, layout));
+}
+
+QString NumberSerializer::formatValue(qint64 value)
+{
+    char text[MaxEntrySize];
+    const char *end = std::to_chars(text, text + sizeof(text), value).ptr;
+    return QString::fromLatin1(text, end - text);
+}
+
+QString NumberSerializer::layoutName(Layout layout)
+{
+    switch (layout) {
+    case Layout::Csv:
+        return "csv";
+    case Layout::OnePerLine:
+        return "lines";
+    case Layout::Grouped:
+        break;
+    }
+    return "grouped";
+}
+
+NumberSerializer::Layout NumberSerializer::layoutFromName(const QString &name)
+{
+    for (Layout layout : {Layout::Csv, Layout::OnePerLine}) {
+        if (name == layoutName(layout)) {
+            return layout;
+        }
+    }
+    return Layout::Grouped;
+}
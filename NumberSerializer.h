@@ -0,0 +1,57 @@
+// NumberSerializer.h
+#ifndef NUMBERSERIALIZER_H
+#define NUMBERSERIALIZER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <QString>
+#include <vector>
+
+// 数字序列化
+// 用 std::to_chars 直接格式化到预先分配的字节缓冲区，写设备时以大块为单位；
+// 结果显示、复制、历史记录和流式输出共用这一份格式实现。
+// 分隔符取决于数字是否为最后一个，因此构造时需要给出总数，然后按顺序分批序列化。
+// 每行的数字个数可以指定，批量抽取时每次抽取占一行。
+class NumberSerializer
+{
+public:
+    enum class Layout {
+        Grouped,   // ", " 分隔，每 10 个换行(原有格式)
+        Csv,       // "," 分隔，每 10 个一行
+        OnePerLine // 每行一个
+    };
+
+    static constexpr int ValuesPerLine = 10;
+    static constexpr qsizetype MaxEntrySize = 24; // 最长 20 个字符，加上分隔符和换行
+    static constexpr qsizetype BufferSize = 4 * 1024 * 1024;
+
+    NumberSerializer(Layout layout, qint64 total, qint64 valuesPerLine = ValuesPerLine);
+
+    // 序列化接下来的 count 个数字到 out，返回写入结束的位置；out 至少要有 count * MaxEntrySize 字节
+    char *serialize(const qint64 *values, qsizetype count, char *out);
+
+    // 序列化后先放入 BufferSize 大小的缓冲区，满了再写入设备；最后需要调用 flush()
+    bool write(QIODevice *device, const qint64 *values, qsizetype count);
+    bool flush(QIODevice *device);
+
+    static QByteArray toBytes(const QList<qint64> &numbers, Layout layout = Layout::Grouped);
+    static QString toString(const QList<qint64> &numbers, Layout layout = Layout::Grouped);
+    // 单个数字，供表格显示
+    static QString formatValue(qint64 value);
+
+    // 设置文件中保存的名称
+    static QString layoutName(Layout layout);
+    static Layout layoutFromName(const QString &name);
+
+private:
+    Layout m_layout;
+    qint64 m_total;
+    qint64 m_valuesPerLine;
+    qint64 m_index = 0;
+    qint64 m_column = 0; // 当前行已写的数字个数
+    std::vector<char> m_buffer;
+    qsizetype m_used = 0;
+};
+
+#endif // NUMBERSERIALIZER_H
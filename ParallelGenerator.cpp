@@ -0,0 +1,74 @@
+// ParallelGenerator.cpp
+#include "ParallelGenerator.h"
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+
+bool ParallelGenerator::generate(const Params &params, qint64 first, qint64 count, qint64 *out,
+                                 const ProgressCallback &progress, int threadCount, QThreadPool *pool)
+{
+    if (count <= 0) {
+        return true;
+    }
+
+    // 各线程复制一份，只共享配置
+    const DrawEngine engine(params.min, params.max, params.excluded, params.engine, params.seed, params.distribution);
+
+    const qint64 firstBlock = first / BlockSize;
+    const qint64 blockCount = (first + count - 1) / BlockSize - firstBlock + 1;
+
+    std::atomic<qint64> nextBlock{0};
+    std::atomic<qint64> done{0};
+    std::atomic<bool> canceled{false};
+
+    auto worker = [&]() {
+        DrawEngine blockEngine = engine;
+        for (qint64 b = nextBlock.fetch_add(1, std::memory_order_relaxed); b < blockCount;
+             b = nextBlock.fetch_add(1, std::memory_order_relaxed)) {
+            if (canceled.load(std::memory_order_relaxed)) {
+                return;
+            }
+
+            const qint64 block = firstBlock + b;
+            const qint64 blockStart = block * BlockSize;
+            const qint64 begin = std::max(first, blockStart);
+            const qint64 end = std::min(first + count, blockStart + BlockSize);
+
+            blockEngine.seek(begin);
+            const std::span<qint64> result(out + (begin - first), size_t(end - begin));
+            if (params.unique) {
+                blockEngine.sampleUnique(result);
+            } else {
+                blockEngine.fill(result);
+            }
+
+            done.fetch_add(end - begin, std::memory_order_relaxed);
+        }
+    };
+
+    int threads = threadCount > 0 ? threadCount : pool ? pool->maxThreadCount() : QThread::idealThreadCount();
+    threads = int(std::min<qint64>(threads, blockCount));
+
+    if (threads <= 1 && !progress) {
+        worker();
+        return true;
+    }
+
+    QThreadPool localPool;
+    if (!pool) {
+        pool = &localPool;
+        pool->setMaxThreadCount(threads);
+    }
+    for (int t = 0; t < threads; ++t) {
+        pool->start(worker);
+    }
+
+    while (!pool->waitForDone(50)) {
+        if (progress && !progress(done.load(std::memory_order_relaxed), count)) {
+            canceled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    return !canceled.load(std::memory_order_relaxed);
+}
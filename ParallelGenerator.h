@@ -0,0 +1,39 @@
+// ParallelGenerator.h
+#ifndef PARALLELGENERATOR_H
+#define PARALLELGENERATOR_H
+
+#include <functional>
+#include "DrawEngine.h"
+
+class QThreadPool;
+
+// 多线程批量生成
+// 输出按 BlockSize 分块，每块由 DrawEngine 生成，第 b 块只由种子和 b 决定。
+// 各线程从共享计数器领取块，因此结果与线程数和调度顺序无关，同一种子总是得到相同结果。
+class ParallelGenerator
+{
+public:
+    static constexpr qint64 BlockSize = DrawEngine::BlockSize;
+
+    // 在调用线程中周期性调用，返回 false 表示取消
+    using ProgressCallback = std::function<bool(qint64 done, qint64 total)>;
+
+    struct Params
+    {
+        qint64 min = 0;
+        qint64 max = 0;
+        ExclusionSet excluded; // 已裁剪到 [min, max]
+        bool unique = true;
+        quint64 seed = 0;
+        EngineType engine = EngineType::Xoshiro256StarStar;
+        std::shared_ptr<const Distribution> distribution; // 非空时按该分布可重复抽样
+    };
+
+    // 生成第 [first, first + count) 个结果写入 out；取消时返回 false
+    // threadCount 为 0 时使用 QThread::idealThreadCount()；
+    // pool 非空时在其中运行，连续多次调用可复用同一组线程，threadCount 为 0 时使用 pool 的最大线程数
+    static bool generate(const Params &params, qint64 first, qint64 count, qint64 *out,
+                         const ProgressCallback &progress = {}, int threadCount = 0, QThreadPool *pool = nullptr);
+};
+
+#endif // PARALLELGENERATOR_H
@@ -0,0 +1,286 @@
+// RandomEngine.h
+#ifndef RANDOMENGINE_H
+#define RANDOMENGINE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <iterator>
+#include <random>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 64 位乘法，返回高 64 位，低 64 位写入 low
+inline quint64 mulHigh64(quint64 a, quint64 b, quint64 *low)
+{
+#if defined(_MSC_VER)
+    quint64 high;
+    *low = _umul128(a, b, &high);
+    return high;
+#else
+    const unsigned __int128 product = (unsigned __int128)a * b;
+    *low = quint64(product);
+    return quint64(product >> 64);
+#endif
+}
+
+// SplitMix64，用于从种子派生引擎状态
+class SplitMix64
+{
+public:
+    explicit SplitMix64(quint64 seed) : m_state(seed) {}
+
+    quint64 operator()()
+    {
+        quint64 z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    quint64 m_state;
+};
+
+// 随机数引擎接口
+// 引擎由 (种子, 流号) 构造，不同流号得到互相独立的随机流；每次调用返回 64 位均匀随机数。
+// 所有生成代码都以模板形式针对具体引擎实例化，调用不经过虚函数。
+template <typename Engine>
+concept RandomEngine = requires(Engine engine, quint64 seed, quint64 stream) {
+    Engine(seed, stream);
+    { engine() } -> std::same_as<quint64>;
+};
+
+// xoshiro256**：速度最快，适合大批量生成
+class Xoshiro256StarStar
+{
+public:
+    Xoshiro256StarStar(quint64 seed, quint64 stream)
+    {
+        // 先把流号混入种子，再用 SplitMix64 展开为 256 位状态(不会得到全零状态)
+        SplitMix64 mixer(seed ^ SplitMix64(stream ^ 0xD1B54A32D192ED03ULL)());
+        for (quint64 &word : m_state) {
+            word = mixer();
+        }
+    }
+
+    quint64 operator()()
+    {
+        const quint64 result = std::rotl(m_state[1] * 5, 7) * 9;
+        const quint64 t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = std::rotl(m_state[3], 45);
+
+        return result;
+    }
+
+private:
+    quint64 m_state[4];
+};
+
+// PCG64 (XSL-RR 128/64)：流号直接作为 LCG 增量
+class Pcg64
+{
+public:
+    Pcg64(quint64 seed, quint64 stream)
+        : m_stateHigh(0), m_stateLow(0), m_incHigh(stream >> 63), m_incLow((stream << 1) | 1)
+    {
+        step();
+        add(0, seed);
+        step();
+    }
+
+    quint64 operator()()
+    {
+        step();
+        return std::rotr(m_stateHigh ^ m_stateLow, int(m_stateHigh >> 58));
+    }
+
+private:
+    static constexpr quint64 MultiplierHigh = 0x2360ED051FC65DA4ULL;
+    static constexpr quint64 MultiplierLow = 0x4385DF649FCCF645ULL;
+
+    // state = state * multiplier + increment (mod 2^128)
+    void step()
+    {
+        quint64 low;
+        const quint64 high = mulHigh64(m_stateLow, MultiplierLow, &low)
+                             + m_stateLow * MultiplierHigh + m_stateHigh * MultiplierLow;
+        m_stateHigh = high;
+        m_stateLow = low;
+        add(m_incHigh, m_incLow);
+    }
+
+    void add(quint64 high, quint64 low)
+    {
+        m_stateLow += low;
+        m_stateHigh += high + (m_stateLow < low ? 1 : 0);
+    }
+
+    quint64 m_stateHigh;
+    quint64 m_stateLow;
+    quint64 m_incHigh;
+    quint64 m_incLow;
+};
+
+// 标准库 mt19937_64
+class Mt19937_64
+{
+public:
+    Mt19937_64(quint64 seed, quint64 stream)
+        : m_engine(seed ^ SplitMix64(stream ^ 0x9E3779B97F4A7C15ULL)())
+    {
+    }
+
+    quint64 operator()() { return quint64(m_engine()); }
+
+private:
+    std::mt19937_64 m_engine;
+};
+
+// ChaCha20 密钥流：密钥由种子展开，流号作为 nonce，块计数器递增
+// 输出具备密码学强度，但整体熵受 64 位种子限制；需要不可预测的结果时应使用系统熵源生成种子。
+class ChaCha20
+{
+public:
+    ChaCha20(quint64 seed, quint64 stream)
+    {
+        SplitMix64 mixer(seed);
+        for (int i = 0; i < 8; i += 2) {
+            const quint64 word = mixer();
+            m_key[i] = quint32(word);
+            m_key[i + 1] = quint32(word >> 32);
+        }
+        m_nonce[0] = quint32(stream);
+        m_nonce[1] = quint32(stream >> 32);
+    }
+
+    quint64 operator()()
+    {
+        if (m_position == 8) {
+            refill();
+        }
+        return m_output[m_position++];
+    }
+
+private:
+    static void quarterRound(quint32 &a, quint32 &b, quint32 &c, quint32 &d)
+    {
+        a += b; d ^= a; d = std::rotl(d, 16);
+        c += d; b ^= c; b = std::rotl(b, 12);
+        a += b; d ^= a; d = std::rotl(d, 8);
+        c += d; b ^= c; b = std::rotl(b, 7);
+    }
+
+    void refill()
+    {
+        const quint32 input[16] = {
+            0x61707865, 0x3320646E, 0x79622D32, 0x6B206574,
+            m_key[0], m_key[1], m_key[2], m_key[3],
+            m_key[4], m_key[5], m_key[6], m_key[7],
+            quint32(m_counter), quint32(m_counter >> 32), m_nonce[0], m_nonce[1]
+        };
+
+        quint32 x[16];
+        std::copy(std::begin(input), std::end(input), x);
+        for (int round = 0; round < 10; ++round) {
+            quarterRound(x[0], x[4], x[8], x[12]);
+            quarterRound(x[1], x[5], x[9], x[13]);
+            quarterRound(x[2], x[6], x[10], x[14]);
+            quarterRound(x[3], x[7], x[11], x[15]);
+            quarterRound(x[0], x[5], x[10], x[15]);
+            quarterRound(x[1], x[6], x[11], x[12]);
+            quarterRound(x[2], x[7], x[8], x[13]);
+            quarterRound(x[3], x[4], x[9], x[14]);
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            m_output[i] = quint64(x[2 * i] + input[2 * i]) | (quint64(x[2 * i + 1] + input[2 * i + 1]) << 32);
+        }
+        ++m_counter;
+        m_position = 0;
+    }
+
+    quint32 m_key[8];
+    quint32 m_nonce[2];
+    quint64 m_counter = 0;
+    quint64 m_output[8];
+    int m_position = 8;
+};
+
+// 可在设置中选择的引擎
+enum class EngineType {
+    Xoshiro256StarStar,
+    Pcg64,
+    Mt19937_64,
+    ChaCha20
+};
+
+// 设置文件中保存的名称
+inline QString engineName(EngineType type)
+{
+    switch (type) {
+    case EngineType::Pcg64:
+        return "pcg64";
+    case EngineType::Mt19937_64:
+        return "mt19937_64";
+    case EngineType::ChaCha20:
+        return "chacha20";
+    case EngineType::Xoshiro256StarStar:
+        break;
+    }
+    return "xoshiro256**";
+}
+
+inline EngineType engineFromName(const QString &name)
+{
+    for (EngineType type : {EngineType::Pcg64, EngineType::Mt19937_64, EngineType::ChaCha20}) {
+        if (name == engineName(type)) {
+            return type;
+        }
+    }
+    return EngineType::Xoshiro256StarStar;
+}
+
+// 按引擎类型分派到针对该引擎实例化的模板代码：function(std::type_identity<Engine>())
+template <typename Function>
+decltype(auto) withEngine(EngineType type, Function &&function)
+{
+    switch (type) {
+    case EngineType::Pcg64:
+        return function(std::type_identity<Pcg64>());
+    case EngineType::Mt19937_64:
+        return function(std::type_identity<Mt19937_64>());
+    case EngineType::ChaCha20:
+        return function(std::type_identity<ChaCha20>());
+    case EngineType::Xoshiro256StarStar:
+        break;
+    }
+    return function(std::type_identity<Xoshiro256StarStar>());
+}
+
+// [0, range) 内的均匀整数(Lemire 乘法映射，只有落入拒绝区间附近时才需要一次取模)
+template <RandomEngine Engine>
+quint64 boundedRandom(Engine &engine, quint64 range)
+{
+    quint64 low;
+    quint64 high = mulHigh64(engine(), range, &low);
+    if (low < range) {
+        const quint64 threshold = (0 - range) % range;
+        while (low < threshold) {
+            high = mulHigh64(engine(), range, &low);
+        }
+    }
+    return high;
+}
+
+#endif // RANDOMENGINE_H
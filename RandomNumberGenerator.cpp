@@ -1,5 +1,6 @@
 // RandomNumberGenerator.cpp
 #include "RandomNumberGenerator.h"
+#include "UniqueSampler.h"
 #include <QRandomGenerator>
 #include <QScrollBar>
 #include <QClipboard>
@@ -13,32 +14,97 @@
 #include <QApplication>
 #include <QDir>
 #include <QStyleFactory>
+#include <QHeaderView>
+#include <QFontMetrics>
+#include <QInputDialog>
+#include <QCloseEvent>
+#include <algorithm>
+#include <limits>
 
 RandomNumberGenerator::RandomNumberGenerator(QWidget *parent)
-    : QWidget(parent), settingsDialog(nullptr)
+    : QWidget(parent), settingsDialog(nullptr), historyDialog(nullptr), historyWriter(nullptr), saveTimer(nullptr),
+      settingsDirty(false), batchDraws(1000), currentJob(nullptr), jobThread(nullptr)
 {
     setupUI();
     loadSettings();
+    rebuildDrawPlan();
+
+    saveTimer = new QTimer(this);
+    saveTimer->setSingleShot(true);
+    saveTimer->setInterval(SaveSettingsDelay);
+    connect(saveTimer, &QTimer::timeout, this, &RandomNumberGenerator::saveSettings);
+
+    historyWriter = new HistoryWriter(historyOptions, this);
 
     // 创建设置对话框
     settingsDialog = new SettingsDialog(this);
-    settingsDialog->setSettings(minValue, maxValue, countValue, exclusionEnabled, excludedNumbers);
+    settingsDialog->setSettings(minValue, maxValue, countValue, allowDuplicates, engineType, exclusionEnabled, excludedNumbers);
+    settingsDialog->setSeedSettings(seededMode, fixedSeed);
+    settingsDialog->setOutputLayout(outputLayout);
+    settingsDialog->setWeightSettings(weightedMode, weightsText);
+    settingsDialog->setDistribution(distributionParams);
 
     connect(settingsDialog, &SettingsDialog::settingsChanged, this, [this]() {
-        minValue = settingsDialog->getMinValue();
-        maxValue = settingsDialog->getMaxValue();
-        countValue = settingsDialog->getCountValue();
-        exclusionEnabled = settingsDialog->isExclusionEnabled();
-        excludedNumbers = settingsDialog->getExcludedNumbers();
-        saveSettings();
+        // 逐项比较，没有变化时不写配置文件
+        bool changed = false;
+        auto update = [&changed](auto &field, auto value) {
+            if (!(field == value)) {
+                field = std::move(value);
+                changed = true;
+            }
+        };
+        update(minValue, settingsDialog->getMinValue());
+        update(maxValue, settingsDialog->getMaxValue());
+        update(countValue, settingsDialog->getCountValue());
+        update(allowDuplicates, settingsDialog->isDuplicatesAllowed());
+        update(engineType, settingsDialog->getEngineType());
+        update(seededMode, settingsDialog->isSeededMode());
+        update(fixedSeed, settingsDialog->getSeedText());
+        update(outputLayout, settingsDialog->getOutputLayout());
+        update(exclusionEnabled, settingsDialog->isExclusionEnabled());
+        update(excludedNumbers, settingsDialog->getExcludedNumbers());
+        update(weightedMode, settingsDialog->isWeightedMode());
+        update(weightsText, settingsDialog->getWeightsText());
+        update(distributionParams, settingsDialog->getDistribution());
+        if (changed) {
+            rebuildDrawPlan();
+            scheduleSaveSettings();
+        }
         updateResultDisplay();
     });
+
+    historyDialog = new HistoryDialog(this);
+    connect(historyDialog, &HistoryDialog::replayRequested, this, &RandomNumberGenerator::replayRecord);
+    connect(historyDialog, &HistoryDialog::numbersRequested, this, &RandomNumberGenerator::showRecordNumbers);
 }
 
 RandomNumberGenerator::~RandomNumberGenerator()
 {
+    // 取消仍在运行的任务并等待工作线程退出
+    if (currentJob) {
+        currentJob->cancel();
+        jobThread->quit();
+        jobThread->wait();
+        delete currentJob;
+    }
+
+    // 写完队列中的历史记录
+    historyWriter->close();
+
+    // 写入仍在等待合并的修改
     saveSettings();
     delete settingsDialog;
+    delete historyDialog;
+}
+
+void RandomNumberGenerator::closeEvent(QCloseEvent *event)
+{
+    // 关闭前等待队列中的记录写完，写入失败时提示
+    historyWriter->waitForWritten();
+    if (!historyWriter->errorString().isEmpty()) {
+        QMessageBox::warning(this, "错误", QString("历史记录写入失败: %1").arg(historyWriter->errorString()));
+    }
+    QWidget::closeEvent(event);
 }
 
 void RandomNumberGenerator::setupUI()
@@ -57,7 +123,10 @@ void RandomNumberGenerator::setupUI()
     // 创建控件
     settingsButton = new QPushButton("⚙️ 设置");
     generateButton = new QPushButton("🎯 生成随机数");
+    streamButton = new QPushButton("💾 生成到文件");
+    batchButton = new QPushButton("🎟️ 批量抽取");
     copyButton = new QPushButton("📋 复制结果");
+    historyButton = new QPushButton("📜 历史记录");
 
     // 设置按钮样式 - 颜色变浅
     QString buttonStyle = R"(
@@ -89,12 +158,33 @@ void RandomNumberGenerator::setupUI()
 
     settingsButton->setStyleSheet(buttonStyle);
     generateButton->setStyleSheet(buttonStyle);
+    streamButton->setStyleSheet(buttonStyle);
+    batchButton->setStyleSheet(buttonStyle);
     copyButton->setStyleSheet(buttonStyle);
-
-    resultTextEdit = new QTextEdit();
-    resultTextEdit->setReadOnly(true);
-    resultTextEdit->setStyleSheet(R"(
-        QTextEdit {
+    historyButton->setStyleSheet(buttonStyle);
+
+    // 结果表格只格式化可见的行；没有结果时显示提示文字
+    resultModel = new ResultModel(this);
+    resultView = new QTableView();
+    resultView->setModel(resultModel);
+    resultView->setShowGrid(false);
+    resultView->setSelectionMode(QAbstractItemView::NoSelection);
+    resultView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultView->setWordWrap(false);
+    resultView->horizontalHeader()->hide();
+    resultView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    resultView->verticalHeader()->hide();
+    resultView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    resultView->verticalHeader()->setDefaultSectionSize(40);
+
+    resultPlaceholder = new QLabel();
+    resultPlaceholder->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+
+    resultStack = new QStackedWidget();
+    resultStack->addWidget(resultPlaceholder);
+    resultStack->addWidget(resultView);
+    resultStack->setStyleSheet(R"(
+        QTableView, QLabel {
             background-color: white;
             border: 2px solid #dee2e6;
             border-radius: 8px;
@@ -105,7 +195,7 @@ void RandomNumberGenerator::setupUI()
             selection-background-color: #4a90e2;
             selection-color: white;
         }
-        QTextEdit:focus {
+        QTableView:focus {
             border-color: #86b7fe;
             outline: 0;
             box-shadow: 0 0 0 0.25rem rgba(13, 110, 253, 0.25);
@@ -160,17 +250,40 @@ void RandomNumberGenerator::setupUI()
     )");
     infoLabel->setAlignment(Qt::AlignCenter);
 
+    progressBar = new QProgressBar();
+    progressBar->setRange(0, 1000);
+    progressBar->setTextVisible(false);
+    progressBar->setVisible(false);
+    progressBar->setStyleSheet(R"(
+        QProgressBar {
+            background-color: white;
+            border: 2px solid #ced4da;
+            border-radius: 6px;
+            max-height: 12px;
+        }
+        QProgressBar::chunk {
+            background-color: #4a90e2;
+            border-radius: 4px;
+        }
+    )");
+
     // 连接信号和槽
     connect(settingsButton, &QPushButton::clicked, this, &RandomNumberGenerator::showSettingsDialog);
-    connect(generateButton, &QPushButton::clicked, this, &RandomNumberGenerator::generateRandomNumbers);
+    connect(generateButton, &QPushButton::clicked, this, &RandomNumberGenerator::toggleGeneration);
+    connect(streamButton, &QPushButton::clicked, this, &RandomNumberGenerator::generateToFile);
+    connect(batchButton, &QPushButton::clicked, this, &RandomNumberGenerator::generateBatch);
     connect(copyButton, &QPushButton::clicked, this, &RandomNumberGenerator::copyToClipboard);
+    connect(historyButton, &QPushButton::clicked, this, &RandomNumberGenerator::showHistoryDialog);
 
     // 布局设置
     QHBoxLayout *buttonLayout = new QHBoxLayout();
     buttonLayout->setSpacing(15);
     buttonLayout->addWidget(settingsButton);
     buttonLayout->addWidget(generateButton);
+    buttonLayout->addWidget(streamButton);
+    buttonLayout->addWidget(batchButton);
     buttonLayout->addWidget(copyButton);
+    buttonLayout->addWidget(historyButton);
     buttonLayout->addStretch();
 
     QVBoxLayout *mainLayout = new QVBoxLayout();
@@ -179,130 +292,291 @@ void RandomNumberGenerator::setupUI()
 
     mainLayout->addWidget(infoLabel);
     mainLayout->addLayout(buttonLayout);
-    mainLayout->addWidget(resultTextEdit, 1);
+    mainLayout->addWidget(progressBar);
+    mainLayout->addWidget(resultStack, 1);
 
     setLayout(mainLayout);
 }
 
 
-void RandomNumberGenerator::generateRandomNumbers()
+void RandomNumberGenerator::rebuildDrawPlan()
+{
+    // 只在设置改变时编译一次，之后每次生成都直接使用
+    const ExclusionSet excluded = exclusionEnabled ? excludedNumbers : ExclusionSet();
+    if (!weightedMode) {
+        drawPlan = std::make_shared<const DrawPlan>(minValue, maxValue, countValue, !allowDuplicates, excluded,
+                                                    nullptr, distributionParams);
+        return;
+    }
+
+    WeightTable::Weights weights;
+    QString errorString;
+    if (!WeightTable::parse(weightsText, &weights, &errorString)) {
+        drawPlan = std::make_shared<const DrawPlan>(errorString);
+        return;
+    }
+    drawPlan = std::make_shared<const DrawPlan>(minValue, maxValue, countValue, !allowDuplicates, excluded, &weights,
+                                                distributionParams);
+}
+
+bool RandomNumberGenerator::validateSettings()
 {
-    if (minValue >= maxValue) {
-        QMessageBox::warning(this, "输入错误", "最大值必须大于最小值");
+    if (!drawPlan->isValid()) {
+        QMessageBox::warning(this, "错误", drawPlan->errorString());
+        return false;
+    }
+    return true;
+}
+
+void RandomNumberGenerator::toggleGeneration()
+{
+    // 任务运行时按钮处于取消状态
+    if (currentJob) {
+        currentJob->cancel();
+        generateButton->setEnabled(false);
         return;
     }
 
-    // 获取排除的数字
-    QList<int> excluded = exclusionEnabled ? excludedNumbers : QList<int>();
+    generateRandomNumbers();
+}
 
-    // 计算可用数字范围
-    int availableNumbers = (maxValue - minValue + 1) - excluded.size();
-    if (availableNumbers <= 0) {
-        QMessageBox::warning(this, "错误", "所有可能的数字都被排除了！");
+void RandomNumberGenerator::generateRandomNumbers()
+{
+    if (!validateSettings()) {
         return;
     }
 
-    if (countValue > availableNumbers) {
+    if (countValue > GenerationJob::MaxInMemoryCount) {
         QMessageBox::warning(this, "错误",
-            QString("请求的数量(%1)超过了可用数字的数量(%2)").arg(countValue).arg(availableNumbers));
+            QString("数量超过 %1 时请使用\"生成到文件\"").arg(GenerationJob::MaxInMemoryCount));
         return;
     }
 
-    // 生成随机数
-    currentNumbers.clear();
+    // 生成、格式化和历史记录都在工作线程中完成；排除集合和权重表与计划共享
+    startJob(drawPlan->request(nextSeed(), engineType, seededMode));
+}
 
-    for (int i = 0; i < countValue; ++i) {
-        int randomNumber;
-        do {
-            randomNumber = QRandomGenerator::global()->bounded(minValue, maxValue + 1);
-        } while (isNumberExcluded(randomNumber) || currentNumbers.contains(randomNumber));
+void RandomNumberGenerator::generateToFile()
+{
+    if (!validateSettings()) {
+        return;
+    }
 
-        currentNumbers.append(randomNumber);
+    const bool csv = outputLayout == NumberSerializer::Layout::Csv;
+    QString filePath = QFileDialog::getSaveFileName(this, "生成到文件",
+                                                    QDir::current().filePath(csv ? "random_numbers.csv"
+                                                                                 : "random_numbers.txt"),
+                                                    csv ? "CSV 文件 (*.csv);;所有文件 (*)"
+                                                        : "文本文件 (*.txt);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
     }
 
-    updateResultDisplay();
-    saveToHistoryFile(); // 自动保存到历史文件
+    startJob(drawPlan->request(nextSeed(), engineType, seededMode, filePath, outputLayout));
 }
 
-void RandomNumberGenerator::copyToClipboard()
+void RandomNumberGenerator::generateBatch()
 {
-    QString text = resultTextEdit->toPlainText();
-    if (!text.isEmpty()) {
-        QApplication::clipboard()->setText(text);
-        QMessageBox::information(this, "复制成功", "结果已复制到剪贴板");
+    if (!validateSettings()) {
+        return;
+    }
+
+    // 按当前设置独立抽取多次，每次一行写入文件，整批只记一条历史记录
+    if (countValue > GenerationJob::MaxBatchCount) {
+        QMessageBox::warning(this, "错误",
+                             QString("批量抽取时每次的数量不能超过 %1").arg(GenerationJob::MaxBatchCount));
+        return;
+    }
+    bool ok = false;
+    const int draws = QInputDialog::getInt(this, "批量抽取", QString("抽取次数(每次 %1 个):").arg(countValue),
+                                           batchDraws, 1, std::numeric_limits<int>::max(), 1, &ok);
+    if (!ok) {
+        return;
+    }
+    if (draws > std::numeric_limits<qint64>::max() / countValue) {
+        QMessageBox::warning(this, "错误", "抽取的总数量过大");
+        return;
+    }
+    batchDraws = draws;
+
+    QString filePath = QFileDialog::getSaveFileName(this, "批量抽取到文件",
+                                                    QDir::current().filePath("draws.csv"),
+                                                    "CSV 文件 (*.csv);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
     }
+
+    GenerationJob::Request request = drawPlan->request(nextSeed(), engineType, seededMode, filePath);
+    request.draws = draws;
+    startJob(std::move(request));
 }
 
-// 删除了 saveToFile() 方法
+quint64 RandomNumberGenerator::nextSeed() const
+{
+    // 可复现模式下优先使用用户指定的种子
+    if (seededMode && !fixedSeed.isEmpty()) {
+        return fixedSeed.toULongLong();
+    }
+    return QRandomGenerator::global()->generate64();
+}
 
-void RandomNumberGenerator::saveToHistoryFile()
+void RandomNumberGenerator::replayRecord(const DrawRecord &record)
 {
-    if (currentNumbers.isEmpty()) {
+    GenerationJob::Request request{record.min, record.max, record.count, ExclusionSet(), QString(),
+                                   record.unique, record.seed, record.engine, true, true, outputLayout};
+
+    // 排除集合按哈希单独保存，哈希不符说明文件缺失或被修改，无法得到原来的结果
+    if (!HistoryFile::loadExclusionSet(record.exclusionHash, &request.excluded)) {
+        QMessageBox::warning(this, "错误", "找不到该记录的排除数字文件，无法重新生成");
         return;
     }
 
-    QString historyFilePath = QDir::current().filePath("history.txt");
-    QFile file(historyFilePath);
-
-    if (file.open(QIODevice::Append | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << QString("=").repeated(50) << "\n";
-        writeRandomNumbersToStream(out, false);
-        file.close();
+    if (record.count > GenerationJob::MaxInMemoryCount) {
+        request.outputPath = QFileDialog::getSaveFileName(this, "重新生成到文件",
+                                                          QDir::current().filePath("random_numbers.txt"),
+                                                          "文本文件 (*.txt);;所有文件 (*)");
+        if (request.outputPath.isEmpty()) {
+            return;
+        }
     }
+
+    startJob(std::move(request));
+}
+
+void RandomNumberGenerator::startJob(GenerationJob::Request request)
+{
+    jobThread = new QThread(this);
+    currentJob = new GenerationJob(std::move(request), historyWriter);
+    currentJob->moveToThread(jobThread);
+
+    connect(jobThread, &QThread::started, currentJob, &GenerationJob::run);
+    connect(currentJob, &GenerationJob::progress, this, &RandomNumberGenerator::updateJobProgress);
+    connect(currentJob, &GenerationJob::finished, this, &RandomNumberGenerator::finishJob);
+
+    setBusy(true);
+    jobThread->start();
 }
 
-void RandomNumberGenerator::writeRandomNumbersToStream(QTextStream &out, bool includeHeader)
+void RandomNumberGenerator::showRecordNumbers(const DrawRecord &record, const QList<qint64> &numbers)
 {
-    if (includeHeader) {
-        out << "随机数生成记录\n";
-        out << "生成时间: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") << "\n";
-        out << "范围: " << minValue << " - " << maxValue << "\n";
-        out << "数量: " << countValue << "\n";
-        out << "排除数字: ";
-
-        if (exclusionEnabled && !excludedNumbers.isEmpty()) {
-            for (int i = 0; i < excludedNumbers.size(); ++i) {
-                out << excludedNumbers[i];
-                if (i < excludedNumbers.size() - 1) {
-                    out << ", ";
-                }
+    resultModel->setNumbers(numbers);
+    updateResultColumnWidth(record.min, record.max);
+    updateResultDisplay();
+    infoLabel->setText(QString("历史记录 %1: 范围: %2 - %3, 数量: %4%5")
+                           .arg(record.time.toString("yyyy-MM-dd hh:mm:ss"))
+                           .arg(record.min)
+                           .arg(record.max)
+                           .arg(record.count)
+                           .arg(record.unique ? "" : "(可重复)"));
+}
+
+void RandomNumberGenerator::updateJobProgress(qint64 done, qint64 total)
+{
+    progressBar->setValue(int(done * 1000 / total));
+}
+
+void RandomNumberGenerator::finishJob()
+{
+    jobThread->quit();
+    jobThread->wait();
+
+    const GenerationJob::Request &request = currentJob->request();
+
+    switch (currentJob->status()) {
+    case GenerationJob::Status::Finished:
+        if (request.outputPath.isEmpty()) {
+            // 结果直接移交给表格模型，不复制也不预先格式化
+            resultModel->setNumbers(currentJob->takeNumbers());
+            updateResultColumnWidth(request.min, request.max);
+            updateResultDisplay();
+            if (request.replay) {
+                infoLabel->setText(QString("重新生成: 范围: %1 - %2, 数量: %3%4, 种子: %5")
+                                       .arg(request.min)
+                                       .arg(request.max)
+                                       .arg(request.count)
+                                       .arg(request.unique ? "" : "(可重复)")
+                                       .arg(request.seed));
+            } else if (request.seeded) {
+                infoLabel->setText(infoLabel->text() + QString(", 种子: %1").arg(request.seed));
             }
+        } else if (request.draws > 1) {
+            const double seconds = double(currentJob->elapsedNanoseconds()) / 1e9;
+            QMessageBox::information(this, "批量抽取完成",
+                QString("已完成 %1 次抽取(每次 %2 个)到\n%3\n用时 %4 秒，约 %5 次/秒")
+                    .arg(request.draws)
+                    .arg(request.count)
+                    .arg(request.outputPath)
+                    .arg(seconds, 0, 'f', 2)
+                    .arg(qint64(double(request.draws) / std::max(seconds, 1e-9))));
         } else {
-            out << "无";
+            QMessageBox::information(this, "生成完成",
+                QString("已生成 %1 个随机数到\n%2").arg(request.count).arg(request.outputPath));
         }
-        out << "\n\n";
-    } else {
-        out << "生成时间: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss") << "\n";
-        out << "范围: " << minValue << " - " << maxValue << "\n";
-        out << "数量: " << countValue << "\n";
+        break;
+    case GenerationJob::Status::Canceled:
+        infoLabel->setText(request.outputPath.isEmpty() ? "生成已取消" : "生成已取消，未写入文件");
+        break;
+    case GenerationJob::Status::Failed:
+        QMessageBox::warning(this, "错误", QString("写入文件失败: %1").arg(currentJob->errorString()));
+        break;
+    case GenerationJob::Status::Running:
+        break;
     }
 
-    out << "生成的随机数:\n";
-    for (int i = 0; i < currentNumbers.size(); ++i) {
-        out << currentNumbers[i];
-        if (i < currentNumbers.size() - 1) {
-            out << ", ";
-        }
-        if (i % 10 == 9) {
-            out << "\n";
-        }
+    delete currentJob;
+    currentJob = nullptr;
+    delete jobThread;
+    jobThread = nullptr;
+
+    setBusy(false);
+}
+
+void RandomNumberGenerator::setBusy(bool busy)
+{
+    generateButton->setText(busy ? "⛔ 取消生成" : "🎯 生成随机数");
+    generateButton->setEnabled(true);
+    streamButton->setEnabled(!busy);
+    batchButton->setEnabled(!busy);
+    settingsButton->setEnabled(!busy);
+    historyButton->setEnabled(!busy);
+    progressBar->setValue(0);
+    progressBar->setVisible(busy);
+}
+
+void RandomNumberGenerator::copyToClipboard()
+{
+    QString text = NumberSerializer::toString(resultModel->numbers(), outputLayout);
+    if (!text.isEmpty()) {
+        QApplication::clipboard()->setText(text);
+        QMessageBox::information(this, "复制成功", "结果已复制到剪贴板");
     }
-    out << "\n\n";
 }
 
 void RandomNumberGenerator::showSettingsDialog()
 {
-    settingsDialog->setSettings(minValue, maxValue, countValue, exclusionEnabled, excludedNumbers);
+    settingsDialog->setSettings(minValue, maxValue, countValue, allowDuplicates, engineType, exclusionEnabled, excludedNumbers);
     settingsDialog->exec();
 }
 
+void RandomNumberGenerator::showHistoryDialog()
+{
+    // 列表只读取日志文件，先等待队列中的记录写完
+    historyWriter->waitForWritten();
+    historyDialog->reload();
+    historyDialog->exec();
+}
+
 void RandomNumberGenerator::updateResultDisplay()
 {
-    QString infoText = QString("范围: %1 - %2, 数量: %3, 排除: ")
+    QString infoText = QString("范围: %1 - %2, 数量: %3%4%5%6, 排除: ")
                           .arg(minValue)
                           .arg(maxValue)
-                          .arg(countValue);
+                          .arg(countValue)
+                          .arg(allowDuplicates ? "(可重复)" : "")
+                          .arg(weightedMode ? "(按权重)" : "")
+                          .arg(distributionParams.kind == Distribution::Kind::Uniform
+                                   ? QString()
+                                   : QString("(%1)").arg(Distribution::displayName(distributionParams.kind)));
 
     if (exclusionEnabled && !excludedNumbers.isEmpty()) {
         infoText += QString::number(excludedNumbers.size()) + "个数字";
@@ -312,29 +586,23 @@ void RandomNumberGenerator::updateResultDisplay()
 
     infoLabel->setText(infoText);
 
-    // 更新结果显示
-    if (currentNumbers.isEmpty()) {
-        resultTextEdit->setText("点击\"生成随机数\"按钮开始生成");
+    // 更新结果显示(表格只在滚动到某行时才格式化该行)
+    if (resultModel->isEmpty()) {
+        resultPlaceholder->setText("点击\"生成随机数\"按钮开始生成");
+        resultStack->setCurrentWidget(resultPlaceholder);
         return;
     }
 
-    QString result;
-    for (int i = 0; i < currentNumbers.size(); ++i) {
-        result += QString::number(currentNumbers[i]);
-        if (i < currentNumbers.size() - 1) {
-            result += ", ";
-        }
-        if (i % 10 == 9) {
-            result += "\n";
-        }
-    }
-
-    resultTextEdit->setText(result);
+    resultStack->setCurrentWidget(resultView);
 }
 
-bool RandomNumberGenerator::isNumberExcluded(int number) const
+void RandomNumberGenerator::updateResultColumnWidth(qint64 min, qint64 max)
 {
-    return exclusionEnabled && excludedNumbers.contains(number);
+    // 列宽至少能放下范围内最长的数字，窗口太窄时出现水平滚动条而不是截断
+    const QFontMetrics metrics(resultView->font());
+    const int width = std::max(metrics.horizontalAdvance(QString::number(min)),
+                               metrics.horizontalAdvance(QString::number(max)));
+    resultView->horizontalHeader()->setMinimumSectionSize(width + 16);
 }
 
 void RandomNumberGenerator::loadSettings()
@@ -343,30 +611,54 @@ void RandomNumberGenerator::loadSettings()
     QString configPath = QDir::current().filePath("RandomNumberGenerator.ini");
     QSettings settings(configPath, QSettings::IniFormat);
 
-    minValue = settings.value("Settings/minValue", 1).toInt();
-    maxValue = settings.value("Settings/maxValue", 100).toInt();
-    countValue = settings.value("Settings/countValue", 10).toInt();
+    minValue = settings.value("Settings/minValue", 1).toLongLong();
+    maxValue = settings.value("Settings/maxValue", 100).toLongLong();
+    countValue = settings.value("Settings/countValue", 10).toLongLong();
+    allowDuplicates = settings.value("Settings/allowDuplicates", false).toBool();
+    engineType = engineFromName(settings.value("Settings/engine").toString());
+    seededMode = settings.value("Settings/seededMode", false).toBool();
+    fixedSeed = settings.value("Settings/seed").toString();
+    outputLayout = NumberSerializer::layoutFromName(settings.value("Settings/outputLayout").toString());
     exclusionEnabled = settings.value("Settings/exclusionEnabled", false).toBool();
-
-    // 加载排除的数字
-    QString exclusionText = settings.value("Settings/excludedNumbers").toString();
-    excludedNumbers.clear();
-    if (!exclusionText.isEmpty()) {
-        QStringList numbers = exclusionText.split(',', Qt::SkipEmptyParts);
-        for (const QString &numStr : numbers) {
-            bool ok;
-            int num = numStr.trimmed().toInt(&ok);
-            if (ok) {
-                excludedNumbers.append(num);
-            }
-        }
+    weightedMode = settings.value("Settings/weightedMode", false).toBool();
+    weightsText = settings.value("Settings/weights").toString();
+    distributionParams.kind = Distribution::kindFromName(settings.value("Settings/distribution").toString());
+    distributionParams.mean = settings.value("Settings/distributionMean", 0.0).toDouble();
+    distributionParams.stddev = settings.value("Settings/distributionStddev", 1.0).toDouble();
+    distributionParams.trials = settings.value("Settings/distributionTrials", 10).toLongLong();
+    distributionParams.probability = settings.value("Settings/distributionProbability", 0.5).toDouble();
+    distributionParams.bounds = settings.value("Settings/distributionClamp", false).toBool()
+                                    ? Distribution::Bounds::Clamp
+                                    : Distribution::Bounds::Reject;
+
+    // 加载排除的数字：按区间保存，旧版本的逐个数字列表在下次保存时转换
+    if (settings.contains("Settings/excludedRanges")) {
+        excludedNumbers = ExclusionSet::fromString(settings.value("Settings/excludedRanges").toString());
+    } else {
+        excludedNumbers = ExclusionSet::fromString(settings.value("Settings/excludedNumbers").toString());
+        settingsDirty = settings.contains("Settings/excludedNumbers");
     }
 
+    // 历史记录写入方式和分段保留策略
+    historyOptions = HistoryWriter::readOptions(settings);
+
     updateResultDisplay();
 }
 
+void RandomNumberGenerator::scheduleSaveSettings()
+{
+    settingsDirty = true;
+    saveTimer->start(); // 重新计时
+}
+
 void RandomNumberGenerator::saveSettings()
 {
+    if (!settingsDirty) {
+        return;
+    }
+    saveTimer->stop();
+    settingsDirty = false;
+
     // 使用应用程序目录下的配置文件
     QString configPath = QDir::current().filePath("RandomNumberGenerator.ini");
     QSettings settings(configPath, QSettings::IniFormat);
@@ -374,12 +666,24 @@ void RandomNumberGenerator::saveSettings()
     settings.setValue("Settings/minValue", minValue);
     settings.setValue("Settings/maxValue", maxValue);
     settings.setValue("Settings/countValue", countValue);
+    settings.setValue("Settings/allowDuplicates", allowDuplicates);
+    settings.setValue("Settings/engine", engineName(engineType));
+    settings.setValue("Settings/seededMode", seededMode);
+    settings.setValue("Settings/seed", fixedSeed);
+    settings.setValue("Settings/outputLayout", NumberSerializer::layoutName(outputLayout));
     settings.setValue("Settings/exclusionEnabled", exclusionEnabled);
-
-    // 保存排除的数字
-    QStringList numStrs;
-    for (int num : excludedNumbers) {
-        numStrs.append(QString::number(num));
-    }
-    settings.setValue("Settings/excludedNumbers", numStrs.join(","));
-}
\ No newline at end of file
+    settings.setValue("Settings/weightedMode", weightedMode);
+    settings.setValue("Settings/weights", weightsText);
+    settings.setValue("Settings/distribution", Distribution::kindName(distributionParams.kind));
+    settings.setValue("Settings/distributionMean", distributionParams.mean);
+    settings.setValue("Settings/distributionStddev", distributionParams.stddev);
+    settings.setValue("Settings/distributionTrials", distributionParams.trials);
+    settings.setValue("Settings/distributionProbability", distributionParams.probability);
+    settings.setValue("Settings/distributionClamp", distributionParams.bounds == Distribution::Bounds::Clamp);
+
+    // 保存排除的数字(区间形式)
+    settings.setValue("Settings/excludedRanges", excludedNumbers.toString());
+    settings.remove("Settings/excludedNumbers");
+
+    HistoryWriter::writeOptions(settings, historyOptions);
+}
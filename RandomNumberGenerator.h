@@ -3,12 +3,21 @@
 #define RANDOMNUMBERGENERATOR_H
 
 #include <QWidget>
-#include <QTextEdit>
+#include <QTableView>
+#include <QStackedWidget>
 #include <QHBoxLayout>
 #include <QSettings>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
 #include "SettingsDialog.h"
+#include "ExclusionSet.h"
+#include "DrawPlan.h"
+#include "GenerationJob.h"
+#include "HistoryDialog.h"
+#include "ResultModel.h"
 
 class RandomNumberGenerator : public QWidget
 {
@@ -18,38 +27,78 @@ public:
     explicit RandomNumberGenerator(QWidget *parent = nullptr);
     ~RandomNumberGenerator();
 
+protected:
+    void closeEvent(QCloseEvent *event) override;
+
 private slots:
+    void toggleGeneration();
     void generateRandomNumbers();
+    void generateToFile();
+    void generateBatch();
+    void updateJobProgress(qint64 done, qint64 total);
+    void finishJob();
     void copyToClipboard();
     void showSettingsDialog();
+    void showHistoryDialog();
+    void replayRecord(const DrawRecord &record);
+    void showRecordNumbers(const DrawRecord &record, const QList<qint64> &numbers);
     void updateResultDisplay();
 
 private:
+    static constexpr int SaveSettingsDelay = 500; // 毫秒
+
     void setupUI();
     void loadSettings();
     void saveSettings();
-    bool isNumberExcluded(int number) const;
-    void saveToHistoryFile(); // 保存到历史文件
-    void writeRandomNumbersToStream(QTextStream &out, bool includeHeader = true); // 写入数据到流
+    void scheduleSaveSettings();
+    void rebuildDrawPlan();
+    bool validateSettings();
+    void startJob(GenerationJob::Request request);
+    void setBusy(bool busy);
+    quint64 nextSeed() const;
+    void updateResultColumnWidth(qint64 min, qint64 max);
 
     SettingsDialog *settingsDialog;
+    HistoryDialog *historyDialog;
+    HistoryWriter *historyWriter;
+    QTimer *saveTimer;   // 合并短时间内的多次修改，只写一次配置文件
+    bool settingsDirty;  // 有尚未写入配置文件的修改
 
     // 控件
     QPushButton *settingsButton;
     QPushButton *generateButton;
+    QPushButton *streamButton;
+    QPushButton *batchButton;
     QPushButton *copyButton;
-    QTextEdit *resultTextEdit;
+    QPushButton *historyButton;
+    QStackedWidget *resultStack;
+    QLabel *resultPlaceholder;
+    QTableView *resultView;
+    ResultModel *resultModel;
     QLabel *infoLabel;
+    QProgressBar *progressBar;
 
     // 当前设置
-    int minValue;
-    int maxValue;
-    int countValue;
+    qint64 minValue;
+    qint64 maxValue;
+    qint64 countValue;
+    bool allowDuplicates;
+    EngineType engineType;
+    bool seededMode;
+    QString fixedSeed; // 可复现模式下用户指定的种子，空表示每次自动生成
+    NumberSerializer::Layout outputLayout; // 复制和输出文件的格式
     bool exclusionEnabled;
-    QList<int> excludedNumbers;
+    ExclusionSet excludedNumbers;
+    bool weightedMode;
+    QString weightsText; // 权重文本，见 WeightTable
+    Distribution::Params distributionParams; // 非均匀分布及其参数
+    std::shared_ptr<const DrawPlan> drawPlan; // 由当前设置编译，设置改变时重建
+    int batchDraws; // 上次批量抽取的次数
+    HistoryWriter::Options historyOptions; // 历史记录的写入方式，只在配置文件中设置
 
-    // 当前生成的数字
-    QList<int> currentNumbers;
+    // 正在运行的生成任务
+    GenerationJob *currentJob;
+    QThread *jobThread;
 };
 
 #endif // RANDOMNUMBERGENERATOR_H
\ No newline at end of file
@@ -0,0 +1,59 @@
+// RankPermutation.cpp
+#include "RankPermutation.h"
+#include <bit>
+
+namespace {
+quint64 splitMix64(quint64 &state)
+{
+    quint64 z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+quint64 mix(quint64 value, quint64 key)
+{
+    quint64 z = value ^ key;
+    z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+    z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+    return z ^ (z >> 33);
+}
+}
+
+RankPermutation::RankPermutation(quint64 size, quint64 key)
+    : m_size(size)
+{
+    // 位宽取偶数，使两半等宽；定义域最多是 size 的 4 倍，循环行走的期望次数不超过 4
+    const int bits = size > 1 ? std::bit_width(size - 1) : 1;
+    m_halfBits = (bits + 1) / 2;
+    m_halfMask = m_halfBits >= 64 ? ~quint64(0) : (quint64(1) << m_halfBits) - 1;
+
+    quint64 state = key;
+    for (quint64 &roundKey : m_roundKeys) {
+        roundKey = splitMix64(state);
+    }
+}
+
+quint64 RankPermutation::operator()(quint64 index) const
+{
+    // 结果落在 [size, 2^bits) 时继续置换，直到回到 [0, size)，保证仍是双射
+    quint64 value = encrypt(index);
+    while (value >= m_size) {
+        value = encrypt(value);
+    }
+    return value;
+}
+
+quint64 RankPermutation::encrypt(quint64 value) const
+{
+    quint64 left = value >> m_halfBits;
+    quint64 right = value & m_halfMask;
+
+    for (quint64 roundKey : m_roundKeys) {
+        const quint64 next = left ^ (mix(right, roundKey) & m_halfMask);
+        left = right;
+        right = next;
+    }
+
+    return (left << m_halfBits) | right;
+}
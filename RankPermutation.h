@@ -0,0 +1,29 @@
+// RankPermutation.h
+#ifndef RANKPERMUTATION_H
+#define RANKPERMUTATION_H
+
+#include <QtGlobal>
+
+// [0, size) 上的伪随机双射(平衡 Feistel 网络 + 循环行走)
+// 第 i 个输出只由密钥和 i 决定，不需要任何额外内存，
+// 因此可以按任意顺序、分块生成不重复的序号。
+class RankPermutation
+{
+public:
+    RankPermutation(quint64 size, quint64 key);
+
+    quint64 size() const { return m_size; }
+    quint64 operator()(quint64 index) const;
+
+private:
+    static constexpr int Rounds = 6;
+
+    quint64 encrypt(quint64 value) const;
+
+    quint64 m_size;
+    int m_halfBits;
+    quint64 m_halfMask;
+    quint64 m_roundKeys[Rounds];
+};
+
+#endif // RANKPERMUTATION_H
@@ -0,0 +1,56 @@
+// ResultModel.cpp
+#include "ResultModel.h"
+#include "NumberSerializer.h"
+#include <algorithm>
+
+ResultModel::ResultModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void ResultModel::setNumbers(QList<qint64> numbers)
+{
+    // 重置只改变行数，视图随后只请求可见单元格
+    beginResetModel();
+    m_numbers = std::move(numbers);
+    endResetModel();
+}
+
+int ResultModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return int((m_numbers.size() + ColumnCount - 1) / ColumnCount);
+}
+
+int ResultModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_numbers.isEmpty()) {
+        return 0;
+    }
+    return int(std::min<qsizetype>(m_numbers.size(), ColumnCount));
+}
+
+QVariant ResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const qsizetype position = qsizetype(index.row()) * ColumnCount + index.column();
+    if (position >= m_numbers.size()) {
+        return QVariant(); // 最后一行不满时多出的单元格
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return NumberSerializer::formatValue(m_numbers[position]);
+    case Qt::ToolTipRole:
+        return QString("第 %1 个").arg(position + 1);
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    default:
+        return QVariant();
+    }
+}
@@ -0,0 +1,32 @@
+// ResultModel.h
+#ifndef RESULTMODEL_H
+#define RESULTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+
+// 生成结果的数据模型
+// 按每行 ColumnCount 个数字排成表格，只保存数字本身；
+// 视图滚动到某一行时才格式化该行，显示开销与结果数量无关。
+class ResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ColumnCount = 10;
+
+    explicit ResultModel(QObject *parent = nullptr);
+
+    void setNumbers(QList<qint64> numbers);
+    const QList<qint64> &numbers() const { return m_numbers; }
+    bool isEmpty() const { return m_numbers.isEmpty(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QList<qint64> m_numbers;
+};
+
+#endif // RESULTMODEL_H
@@ -4,6 +4,12 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QDir>
+#include <QSignalBlocker>
+#include <limits>
 
 SettingsDialog::SettingsDialog(QWidget *parent)
     : QDialog(parent)
@@ -36,7 +42,7 @@ SettingsDialog::SettingsDialog(QWidget *parent)
             color: #495057;
             font-weight: 500;
         }
-        QSpinBox {
+        QAbstractSpinBox {
             background-color: white;
             border: 2px solid #ced4da;
             border-radius: 6px;
@@ -48,20 +54,20 @@ SettingsDialog::SettingsDialog(QWidget *parent)
             selection-background-color: #4a90e2;
             selection-color: white;
         }
-        QSpinBox:focus {
+        QAbstractSpinBox:focus {
             border-color: #86b7fe;
             outline: 0;
             box-shadow: 0 0 0 0.25rem rgba(13, 110, 253, 0.25);
         }
 
-        QSpinBox::up-button{
+        QAbstractSpinBox::up-button{
             width: 20px;
             border-left: 1px solid #ced4da;
             radius: 5px;
             font-size: 12px;
             height: 20px;
         }
-        QSpinBox::down-button{
+        QAbstractSpinBox::down-button{
             width: 20px;
             border-left: 1px solid #ced4da;
             radius: 5px;
@@ -70,17 +76,32 @@ SettingsDialog::SettingsDialog(QWidget *parent)
             image: url(:/chevron-down.svg);
         }
 
-        QSpinBox::up-button{
+        QAbstractSpinBox::up-button{
             width: 20px;
             image: url(:/chevron-up.svg);
             height: 20px;
 
         }
 
-        QSpinBox::up-button:hover, QSpinBox::down-button:hover {
+        QAbstractSpinBox::up-button:hover, QAbstractSpinBox::down-button:hover {
             background-color: #e9ecef;
         }
 
+        QComboBox {
+            background-color: white;
+            border: 2px solid #ced4da;
+            border-radius: 6px;
+            padding: 6px 8px;
+            color: #212529;
+            font-size: 14px;
+            min-width: 160px;
+        }
+        QComboBox::down-arrow {
+            image: url(:/chevron-down.svg);
+            width: 15px;
+            height: 15px;
+        }
+
         QLineEdit {
             background-color: white;
             border: 2px solid #ced4da;
@@ -117,10 +138,11 @@ SettingsDialog::SettingsDialog(QWidget *parent)
         QCheckBox::indicator:hover {
             border-color: #6c757d;
         }
-        QScrollArea {
+        QTableView {
             border: 2px solid #ced4da;
             border-radius: 8px;
             background-color: white;
+            font-size: 14px;
         }
         QScrollBar::up-arrow:vertical{
             width: 15px;
@@ -149,8 +171,17 @@ SettingsDialog::SettingsDialog(QWidget *parent)
         QScrollBar::handle:vertical:hover {
             background: #6c757d;
         }
-        QScrollArea QWidget {
-            background-color: white;
+        QTableView::indicator {
+            width: 18px;
+            height: 18px;
+            border: 2px solid #adb5bd;
+            border-radius: 4px;
+            background: white;
+        }
+        QTableView::indicator:checked {
+            background: #4a90e2;
+            border-color: #357abd;
+            image: url(:/check.svg);
         }
     )");
 
@@ -170,24 +201,25 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     rangeLayout->setSpacing(15);
 
     rangeLayout->addWidget(new QLabel("最小值:"));
-    minSpinBox = new QSpinBox();
-    minSpinBox->setRange(-999999, 999999);
+    // 保留一个值的余量，使 max - min + 1 总能用 64 位无符号数表示
+    minSpinBox = new Int64SpinBox();
+    minSpinBox->setRange(std::numeric_limits<qint64>::min() + 1, std::numeric_limits<qint64>::max());
     minSpinBox->setMinimumWidth(120);
     minSpinBox->setMinimumHeight(20); // 设置最小高度
     rangeLayout->addWidget(minSpinBox);
 
     rangeLayout->addSpacing(20);
     rangeLayout->addWidget(new QLabel("最大值:"));
-    maxSpinBox = new QSpinBox();
-    maxSpinBox->setRange(-999999, 999999);
+    maxSpinBox = new Int64SpinBox();
+    maxSpinBox->setRange(std::numeric_limits<qint64>::min() + 1, std::numeric_limits<qint64>::max());
     maxSpinBox->setMinimumWidth(120);
     maxSpinBox->setMinimumHeight(20); // 设置最小高度
     rangeLayout->addWidget(maxSpinBox);
 
     rangeLayout->addSpacing(20);
     rangeLayout->addWidget(new QLabel("生成数量:"));
-    countSpinBox = new QSpinBox();
-    countSpinBox->setRange(1, 1000);
+    countSpinBox = new Int64SpinBox();
+    countSpinBox->setRange(1, MaxCount);
     countSpinBox->setMinimumWidth(120);
     countSpinBox->setMinimumHeight(20); // 设置最小高度
 
@@ -196,6 +228,118 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     rangeLayout->addStretch();
     basicLayout->addLayout(rangeLayout);
 
+    QHBoxLayout *optionLayout = new QHBoxLayout();
+    optionLayout->setSpacing(15);
+
+    allowDuplicatesCheckBox = new QCheckBox("允许重复(可重复抽样，多线程生成)");
+    optionLayout->addWidget(allowDuplicatesCheckBox);
+
+    optionLayout->addSpacing(20);
+    optionLayout->addWidget(new QLabel("随机数引擎:"));
+    engineComboBox = new QComboBox();
+    engineComboBox->addItem("xoshiro256** (最快)", int(EngineType::Xoshiro256StarStar));
+    engineComboBox->addItem("PCG64", int(EngineType::Pcg64));
+    engineComboBox->addItem("mt19937_64", int(EngineType::Mt19937_64));
+    engineComboBox->addItem("ChaCha20 (密码学强度)", int(EngineType::ChaCha20));
+    optionLayout->addWidget(engineComboBox);
+
+    optionLayout->addSpacing(20);
+    optionLayout->addWidget(new QLabel("输出格式:"));
+    layoutComboBox = new QComboBox();
+    layoutComboBox->addItem("逗号分隔，每行 10 个", int(NumberSerializer::Layout::Grouped));
+    layoutComboBox->addItem("CSV", int(NumberSerializer::Layout::Csv));
+    layoutComboBox->addItem("每行一个", int(NumberSerializer::Layout::OnePerLine));
+    optionLayout->addWidget(layoutComboBox);
+
+    optionLayout->addStretch();
+    basicLayout->addLayout(optionLayout);
+
+    QHBoxLayout *seedLayout = new QHBoxLayout();
+    seedLayout->setSpacing(15);
+
+    seededCheckBox = new QCheckBox("可复现模式(历史记录只保存种子，查看时重新生成)");
+    seedLayout->addWidget(seededCheckBox);
+
+    seedLayout->addSpacing(20);
+    seedLayout->addWidget(new QLabel("种子:"));
+    seedLineEdit = new QLineEdit();
+    seedLineEdit->setPlaceholderText("留空则每次自动生成");
+    seedLineEdit->setValidator(new QRegularExpressionValidator(QRegularExpression("[0-9]{0,20}"), this));
+    seedLineEdit->setMinimumWidth(200);
+    seedLineEdit->setMinimumHeight(20); // 设置最小高度
+    seedLayout->addWidget(seedLineEdit);
+
+    seedLayout->addStretch();
+    basicLayout->addLayout(seedLayout);
+
+    QHBoxLayout *weightLayout = new QHBoxLayout();
+    weightLayout->setSpacing(15);
+
+    weightedCheckBox = new QCheckBox("按权重抽样");
+    weightLayout->addWidget(weightedCheckBox);
+
+    weightsLineEdit = new QLineEdit();
+    weightsLineEdit->setPlaceholderText("数字或区间:权重，如 1-10:5, 42:20；*:权重 设置其余数字(默认 1)");
+    weightsLineEdit->setMinimumHeight(20); // 设置最小高度
+    weightLayout->addWidget(weightsLineEdit, 1);
+
+    importWeightsButton = new QPushButton("导入...");
+    weightLayout->addWidget(importWeightsButton);
+    basicLayout->addLayout(weightLayout);
+
+    // 非均匀分布，只显示所选分布用到的参数
+    QHBoxLayout *distributionLayout = new QHBoxLayout();
+    distributionLayout->setSpacing(15);
+
+    distributionLayout->addWidget(new QLabel("分布:"));
+    distributionComboBox = new QComboBox();
+    for (Distribution::Kind kind : {Distribution::Kind::Uniform, Distribution::Kind::Normal,
+                                    Distribution::Kind::Exponential, Distribution::Kind::Poisson,
+                                    Distribution::Kind::Binomial}) {
+        distributionComboBox->addItem(Distribution::displayName(kind), int(kind));
+    }
+    distributionLayout->addWidget(distributionComboBox);
+
+    meanLabel = new QLabel("均值:");
+    distributionLayout->addWidget(meanLabel);
+    meanSpinBox = new QDoubleSpinBox();
+    meanSpinBox->setRange(-1e15, 1e15);
+    meanSpinBox->setDecimals(4);
+    meanSpinBox->setMinimumHeight(20); // 设置最小高度
+    distributionLayout->addWidget(meanSpinBox);
+
+    stddevLabel = new QLabel("标准差:");
+    distributionLayout->addWidget(stddevLabel);
+    stddevSpinBox = new QDoubleSpinBox();
+    stddevSpinBox->setRange(0.0001, 1e15);
+    stddevSpinBox->setDecimals(4);
+    stddevSpinBox->setMinimumHeight(20); // 设置最小高度
+    distributionLayout->addWidget(stddevSpinBox);
+
+    trialsLabel = new QLabel("试验次数:");
+    distributionLayout->addWidget(trialsLabel);
+    trialsSpinBox = new Int64SpinBox();
+    trialsSpinBox->setRange(1, qint64(1) << 53);
+    trialsSpinBox->setMinimumHeight(20); // 设置最小高度
+    distributionLayout->addWidget(trialsSpinBox);
+
+    probabilityLabel = new QLabel("成功概率:");
+    distributionLayout->addWidget(probabilityLabel);
+    probabilitySpinBox = new QDoubleSpinBox();
+    probabilitySpinBox->setRange(0, 1);
+    probabilitySpinBox->setDecimals(6);
+    probabilitySpinBox->setSingleStep(0.01);
+    probabilitySpinBox->setMinimumHeight(20); // 设置最小高度
+    distributionLayout->addWidget(probabilitySpinBox);
+
+    boundsComboBox = new QComboBox();
+    boundsComboBox->addItem("超出范围时重新抽取", int(Distribution::Bounds::Reject));
+    boundsComboBox->addItem("超出范围时取端点", int(Distribution::Bounds::Clamp));
+    distributionLayout->addWidget(boundsComboBox);
+
+    distributionLayout->addStretch();
+    basicLayout->addLayout(distributionLayout);
+
     // 排除设置
     QGroupBox *exclusionGroup = new QGroupBox("🚫 数字排除设置");
     QVBoxLayout *exclusionLayoutMain = new QVBoxLayout(exclusionGroup);
@@ -205,27 +349,38 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     enableExclusionCheckBox = new QCheckBox("启用数字排除");
     exclusionLayoutMain->addWidget(enableExclusionCheckBox);
 
-    exclusionLayoutMain->addWidget(new QLabel("输入要排除的数字(用逗号分隔):"));
+    exclusionLayoutMain->addWidget(new QLabel("输入要排除的数字(用逗号分隔，可写区间如 100-250):"));
     exclusionLineEdit = new QLineEdit();
     exclusionLineEdit->setValidator(new QRegularExpressionValidator(QRegularExpression("[0-9,-]*"), this));
     exclusionLineEdit->setMinimumHeight(20); // 设置最小高度
     exclusionLayoutMain->addWidget(exclusionLineEdit);
 
-    exclusionLayoutMain->addWidget(new QLabel("或从列表中选择要排除的数字:"));
-
-    // 创建滚动区域和复选框容器
-    exclusionScrollArea = new QScrollArea();
-    exclusionScrollArea->setWidgetResizable(true);
+    exclusionParseTimer = new QTimer(this);
+    exclusionParseTimer->setSingleShot(true);
+    exclusionParseTimer->setInterval(ExclusionParseDelay);
+    exclusionParsePool.setMaxThreadCount(1);
 
-    exclusionContainer = new QWidget();
-    exclusionLayout = new QGridLayout(exclusionContainer);
-    exclusionLayout->setSpacing(8);
-    exclusionLayout->setContentsMargins(10, 10, 10, 10);
-    exclusionButtonGroup = new QButtonGroup(this);
-    exclusionButtonGroup->setExclusive(false);
+    exclusionLayoutMain->addWidget(new QLabel("或从列表中选择要排除的数字:"));
 
-    exclusionScrollArea->setWidget(exclusionContainer);
-    exclusionLayoutMain->addWidget(exclusionScrollArea);
+    // 创建排除数字网格(只绘制可见单元格)
+    exclusionModel = new ExclusionModel(this);
+    exclusionView = new QTableView();
+    exclusionView->setModel(exclusionModel);
+    exclusionView->setShowGrid(false);
+    exclusionView->setSelectionMode(QAbstractItemView::NoSelection);
+    exclusionView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    exclusionView->setFocusPolicy(Qt::NoFocus);
+    exclusionView->horizontalHeader()->hide();
+    exclusionView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    exclusionView->verticalHeader()->hide();
+    exclusionView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    exclusionView->verticalHeader()->setDefaultSectionSize(32);
+    exclusionLayoutMain->addWidget(exclusionView);
+
+    exclusionTruncatedLabel = new QLabel(QString("范围过大，列表只显示前 %1 个数字，其余请通过上方输入框排除")
+                                             .arg(qint64(ExclusionModel::MaxRows) * ExclusionModel::ColumnCount));
+    exclusionTruncatedLabel->setVisible(false);
+    exclusionLayoutMain->addWidget(exclusionTruncatedLabel);
 
     // 按钮
     QHBoxLayout *buttonLayout = new QHBoxLayout();
@@ -294,43 +449,130 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     mainLayout->addLayout(buttonLayout);
 
     // 连接信号和槽
-    connect(minSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::updateRangeLimits);
-    connect(maxSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsDialog::updateRangeLimits);
-    connect(enableExclusionCheckBox, &QCheckBox::toggled, this, &SettingsDialog::toggleExclusionCheckboxes);
-    connect(exclusionLineEdit, &QLineEdit::textChanged, this, &SettingsDialog::updateExclusionFromText);
+    connect(minSpinBox, &Int64SpinBox::valueChanged, this, &SettingsDialog::updateRangeLimits);
+    connect(maxSpinBox, &Int64SpinBox::valueChanged, this, &SettingsDialog::updateRangeLimits);
+    connect(seededCheckBox, &QCheckBox::toggled, seedLineEdit, &QLineEdit::setEnabled);
+    connect(weightedCheckBox, &QCheckBox::toggled, this, &SettingsDialog::toggleWeights);
+    connect(importWeightsButton, &QPushButton::clicked, this, &SettingsDialog::importWeights);
+    connect(distributionComboBox, &QComboBox::currentIndexChanged, this, &SettingsDialog::updateDistributionFields);
+    connect(enableExclusionCheckBox, &QCheckBox::toggled, this, &SettingsDialog::toggleExclusionGrid);
+    connect(exclusionLineEdit, &QLineEdit::textChanged, this, &SettingsDialog::scheduleExclusionParse);
+    connect(exclusionParseTimer, &QTimer::timeout, this, &SettingsDialog::updateExclusionFromText);
+    connect(exclusionModel, &ExclusionModel::exclusionToggled, this, &SettingsDialog::updateExclusionFromGrid);
     connect(okButton, &QPushButton::clicked, this, &SettingsDialog::accept);
     connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
 
     // 初始化
-    updateExclusionCheckboxes();
+    setDistribution(Distribution::Params());
+    updateExclusionGrid();
 }
 
-void SettingsDialog::setSettings(int min, int max, int count, bool exclusionEnabled, const QList<int> &excludedNumbers)
+void SettingsDialog::setSettings(qint64 min, qint64 max, qint64 count, bool allowDuplicates, EngineType engine,
+                                 bool exclusionEnabled, const ExclusionSet &excludedNumbers)
 {
     minSpinBox->setValue(min);
     maxSpinBox->setValue(max);
     countSpinBox->setValue(count);
+    allowDuplicatesCheckBox->setChecked(allowDuplicates);
+    engineComboBox->setCurrentIndex(engineComboBox->findData(int(engine)));
     enableExclusionCheckBox->setChecked(exclusionEnabled);
     
-    // 设置排除的数字
-    QStringList numStrs;
-    for (int num : excludedNumbers) {
-        numStrs.append(QString::number(num));
+    // 设置排除的数字，文本与模型一致，不需要再解析
+    exclusionModel->setExcludedNumbers(excludedNumbers);
+    {
+        const QSignalBlocker blocker(exclusionLineEdit);
+        exclusionLineEdit->setText(excludedNumbers.toString());
     }
-    exclusionLineEdit->setText(numStrs.join(","));
+    exclusionParseTimer->stop();
+    exclusionParsedVersion = ++exclusionTextVersion;
+    exclusionTextStale = false;
     
-    // 更新复选框状态
-    QList<QAbstractButton*> buttons = exclusionButtonGroup->buttons();
-    for (QAbstractButton *button : buttons) {
-        QCheckBox *checkbox = qobject_cast<QCheckBox*>(button);
-        if (checkbox) {
-            int num = exclusionButtonGroup->id(button);
-            checkbox->setChecked(excludedNumbers.contains(num));
-        }
+    toggleExclusionGrid(exclusionEnabled);
+    updateExclusionGrid();
+}
+
+void SettingsDialog::setSeedSettings(bool seeded, const QString &seed)
+{
+    seededCheckBox->setChecked(seeded);
+    seedLineEdit->setText(seed);
+    seedLineEdit->setEnabled(seeded);
+}
+
+void SettingsDialog::setOutputLayout(NumberSerializer::Layout layout)
+{
+    layoutComboBox->setCurrentIndex(layoutComboBox->findData(int(layout)));
+}
+
+void SettingsDialog::setWeightSettings(bool weighted, const QString &weights)
+{
+    weightedCheckBox->setChecked(weighted);
+    weightsLineEdit->setText(weights);
+    toggleWeights(weighted);
+}
+
+void SettingsDialog::toggleWeights(bool checked)
+{
+    weightsLineEdit->setEnabled(checked);
+    importWeightsButton->setEnabled(checked);
+}
+
+void SettingsDialog::setDistribution(const Distribution::Params &params)
+{
+    distributionComboBox->setCurrentIndex(distributionComboBox->findData(int(params.kind)));
+    meanSpinBox->setValue(params.mean);
+    stddevSpinBox->setValue(params.stddev);
+    trialsSpinBox->setValue(params.trials);
+    probabilitySpinBox->setValue(params.probability);
+    boundsComboBox->setCurrentIndex(boundsComboBox->findData(int(params.bounds)));
+    updateDistributionFields();
+}
+
+Distribution::Params SettingsDialog::getDistribution() const
+{
+    Distribution::Params params;
+    params.kind = Distribution::Kind(distributionComboBox->currentData().toInt());
+    params.mean = meanSpinBox->value();
+    params.stddev = stddevSpinBox->value();
+    params.trials = trialsSpinBox->value();
+    params.probability = probabilitySpinBox->value();
+    params.bounds = Distribution::Bounds(boundsComboBox->currentData().toInt());
+    return params;
+}
+
+void SettingsDialog::updateDistributionFields()
+{
+    const auto kind = Distribution::Kind(distributionComboBox->currentData().toInt());
+    const bool hasMean = kind == Distribution::Kind::Normal || kind == Distribution::Kind::Exponential
+                         || kind == Distribution::Kind::Poisson;
+    const bool normal = kind == Distribution::Kind::Normal;
+    const bool binomial = kind == Distribution::Kind::Binomial;
+
+    meanLabel->setVisible(hasMean);
+    meanSpinBox->setVisible(hasMean);
+    stddevLabel->setVisible(normal);
+    stddevSpinBox->setVisible(normal);
+    trialsLabel->setVisible(binomial);
+    trialsSpinBox->setVisible(binomial);
+    probabilityLabel->setVisible(binomial);
+    probabilitySpinBox->setVisible(binomial);
+    boundsComboBox->setVisible(kind != Distribution::Kind::Uniform);
+}
+
+void SettingsDialog::importWeights()
+{
+    const QString filePath = QFileDialog::getOpenFileName(this, "导入权重", QDir::currentPath(),
+                                                          "文本文件 (*.txt *.csv);;所有文件 (*)");
+    if (filePath.isEmpty()) {
+        return;
     }
-    
-    toggleExclusionCheckboxes(exclusionEnabled);
-    updateExclusionCheckboxes();
+
+    WeightTable::Weights weights;
+    QString errorString;
+    if (!WeightTable::importFile(filePath, &weights, &errorString)) {
+        QMessageBox::warning(this, "导入失败", errorString);
+        return;
+    }
+    weightsLineEdit->setText(WeightTable::format(weights));
 }
 
 void SettingsDialog::updateRangeLimits()
@@ -340,154 +582,136 @@ void SettingsDialog::updateRangeLimits()
         minSpinBox->setValue(maxSpinBox->value() - 1);
     }
     
-    // 更新排除数字标签页中的复选框
-    updateExclusionCheckboxes();
+    // 更新排除数字网格
+    updateExclusionGrid();
 }
 
-void SettingsDialog::updateExclusionCheckboxes()
+void SettingsDialog::updateExclusionGrid()
 {
-    // 清除现有复选框
-    QLayoutItem *child;
-    while ((child = exclusionLayout->takeAt(0)) != nullptr) {
-        delete child->widget();
-        delete child;
-    }
-    
-    int min = minSpinBox->value();
-    int max = maxSpinBox->value();
+    qint64 min = minSpinBox->value();
+    qint64 max = maxSpinBox->value();
     
+    // 只改变模型的行数，不随范围大小创建控件
     if (min >= max) {
-        return;
-    }
-    
-    // 创建新的复选框
-    int row = 0;
-    int col = 0;
-    const int maxCols = 10;
-    
-    for (int i = min; i <= max; ++i) {
-        QCheckBox *checkbox = new QCheckBox(QString::number(i));
-        checkbox->setChecked(false);
-        checkbox->setEnabled(enableExclusionCheckBox->isChecked());
-        
-        connect(checkbox, &QCheckBox::toggled, this, &SettingsDialog::updateExclusionFromCheckboxes);
-        
-        exclusionLayout->addWidget(checkbox, row, col);
-        exclusionButtonGroup->addButton(checkbox, i);
-        
-        col++;
-        if (col >= maxCols) {
-            col = 0;
-            row++;
-        }
+        exclusionModel->setRange(0, -1);
+    } else {
+        exclusionModel->setRange(min, max);
     }
+    exclusionTruncatedLabel->setVisible(exclusionModel->isTruncated());
 }
 
-void SettingsDialog::toggleExclusionCheckboxes(bool checked)
+void SettingsDialog::toggleExclusionGrid(bool checked)
 {
-    QList<QAbstractButton*> buttons = exclusionButtonGroup->buttons();
-    for (QAbstractButton *button : buttons) {
-        button->setEnabled(checked);
-    }
-    
+    exclusionView->setEnabled(checked);
     exclusionLineEdit->setEnabled(checked);
 }
 
+void SettingsDialog::scheduleExclusionParse()
+{
+    // 连续输入时只在停顿后解析一次；文本以用户看到的为准，不再用网格的结果覆盖
+    ++exclusionTextVersion;
+    exclusionTextStale = false;
+    exclusionParseTimer->start();
+}
+
 void SettingsDialog::updateExclusionFromText()
 {
-    if (!enableExclusionCheckBox->isChecked()) {
+    if (exclusionTextStale) {
+        // 网格勾选后的停顿：按区间重写文本，不再触发解析
+        exclusionTextStale = false;
+        const QSignalBlocker blocker(exclusionLineEdit);
+        exclusionLineEdit->setText(exclusionModel->excludedNumbers().toString());
         return;
     }
-    
-    // 更新复选框状态
-    QString text = exclusionLineEdit->text();
-    QStringList numbers = text.split(',', Qt::SkipEmptyParts);
-    QList<int> excludedNumbers;
-    
-    for (const QString &numStr : numbers) {
-        bool ok;
-        int num = numStr.trimmed().toInt(&ok);
-        if (ok) {
-            excludedNumbers.append(num);
-        }
+
+    if (!enableExclusionCheckBox->isChecked()) {
+        return;
     }
-    
-    QList<QAbstractButton*> buttons = exclusionButtonGroup->buttons();
-    for (QAbstractButton *button : buttons) {
-        QCheckBox *checkbox = qobject_cast<QCheckBox*>(button);
-        if (checkbox) {
-            int num = exclusionButtonGroup->id(button);
-            checkbox->setChecked(excludedNumbers.contains(num));
-        }
+
+    const quint64 version = exclusionTextVersion;
+    const QString text = exclusionLineEdit->text();
+    if (text.size() < BackgroundParseLength) {
+        exclusionParsedVersion = version;
+        exclusionModel->setExcludedNumbers(ExclusionSet::fromString(text));
+        return;
     }
+
+    // 长文本在后台解析，结果回到界面线程时文本已再次修改则丢弃
+    exclusionParsePool.start([this, version, text]() {
+        ExclusionSet excluded = ExclusionSet::fromString(text);
+        QMetaObject::invokeMethod(this, [this, version, excluded = std::move(excluded)]() {
+            if (version == exclusionTextVersion) {
+                exclusionParsedVersion = version;
+                exclusionModel->setExcludedNumbers(excluded); // 只刷新状态变化的行
+            }
+        }, Qt::QueuedConnection);
+    });
 }
 
-void SettingsDialog::updateExclusionFromCheckboxes()
+void SettingsDialog::updateExclusionFromGrid()
 {
     if (!enableExclusionCheckBox->isChecked()) {
         return;
     }
-    
-    // 更新文本输入
-    QList<int> excludedNumbers;
-    QList<QAbstractButton*> buttons = exclusionButtonGroup->buttons();
-    for (QAbstractButton *button : buttons) {
-        QCheckBox *checkbox = qobject_cast<QCheckBox*>(button);
-        if (checkbox && checkbox->isChecked()) {
-            int num = exclusionButtonGroup->id(button);
-            excludedNumbers.append(num);
-        }
+
+    // 网格中的集合已是最新，文本等停顿后再重写，每次勾选只是单个数字的增量修改
+    exclusionParsedVersion = ++exclusionTextVersion;
+    exclusionTextStale = true;
+    exclusionParseTimer->start();
+}
+
+ExclusionSet SettingsDialog::getExcludedNumbers() const
+{
+    if (!enableExclusionCheckBox->isChecked()) {
+        return ExclusionSet();
     }
-    
-    QStringList numStrs;
-    for (int num : excludedNumbers) {
-        numStrs.append(QString::number(num));
+
+    // 文本还没有解析完时直接解析当前文本
+    if (exclusionParsedVersion != exclusionTextVersion) {
+        return ExclusionSet::fromString(exclusionLineEdit->text());
     }
-    exclusionLineEdit->setText(numStrs.join(","));
+
+    // 文本输入和网格共用同一个排除集合
+    return exclusionModel->excludedNumbers();
 }
 
-QList<int> SettingsDialog::getExcludedNumbers() const
+void SettingsDialog::accept()
 {
-    QList<int> excludedNumbers;
-    
-    if (!enableExclusionCheckBox->isChecked()) {
-        return excludedNumbers;
+    // 种子必须能用 64 位无符号数表示
+    bool ok = true;
+    if (!seedLineEdit->text().isEmpty()) {
+        seedLineEdit->text().toULongLong(&ok);
     }
-    
-    // 从文本输入获取排除的数字
-    QString text = exclusionLineEdit->text();
-    if (!text.isEmpty()) {
-        QStringList numbers = text.split(',', Qt::SkipEmptyParts);
-        for (const QString &numStr : numbers) {
-            bool ok;
-            int num = numStr.trimmed().toInt(&ok);
-            if (ok) {
-                excludedNumbers.append(num);
-            }
+    if (!ok) {
+        QMessageBox::warning(this, "输入错误", "种子必须是 0 - 18446744073709551615 之间的整数");
+        return;
+    }
+
+    if (weightedCheckBox->isChecked()) {
+        WeightTable::Weights weights;
+        QString errorString;
+        if (!WeightTable::parse(weightsLineEdit->text(), &weights, &errorString)) {
+            QMessageBox::warning(this, "输入错误", errorString);
+            return;
         }
     }
-    
-    // 从复选框获取排除的数字
-    QList<QAbstractButton*> buttons = exclusionButtonGroup->buttons();
-    for (QAbstractButton *button : buttons) {
-        QCheckBox *checkbox = qobject_cast<QCheckBox*>(button);
-        if (checkbox && checkbox->isChecked()) {
-            int num = exclusionButtonGroup->id(button);
-            if (!excludedNumbers.contains(num)) {
-                excludedNumbers.append(num);
-            }
+
+    const Distribution::Params distribution = getDistribution();
+    if (distribution.kind != Distribution::Kind::Uniform) {
+        QString errorString;
+        if (weightedCheckBox->isChecked()) {
+            errorString = "按权重抽样时不能再选择非均匀分布";
+        } else if (!allowDuplicatesCheckBox->isChecked()) {
+            errorString = QString("%1只能在允许重复时使用").arg(Distribution::displayName(distribution.kind));
+        } else {
+            Distribution::validate(distribution, &errorString);
+        }
+        if (!errorString.isEmpty()) {
+            QMessageBox::warning(this, "输入错误", errorString);
+            return;
         }
     }
-    
-    // 排序并去重
-    std::sort(excludedNumbers.begin(), excludedNumbers.end());
-    excludedNumbers.erase(std::unique(excludedNumbers.begin(), excludedNumbers.end()), excludedNumbers.end());
-    
-    return excludedNumbers;
-}
 
-void SettingsDialog::accept()
-{
     emit settingsChanged();
     QDialog::accept();
 }
\ No newline at end of file
@@ -2,52 +2,110 @@
 #define SETTINGSDIALOG_H
 
 #include <QDialog>
-#include <QSpinBox>
 #include <QCheckBox>
 #include <QLineEdit>
 #include <QTabWidget>
 #include <QPushButton>
-#include <QGridLayout>
-#include <QScrollArea>
-#include <QButtonGroup>
+#include <QTableView>
 #include <QLabel>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QThreadPool>
+#include <QTimer>
+#include "Distribution.h"
+#include "ExclusionSet.h"
+#include "ExclusionModel.h"
+#include "Int64SpinBox.h"
+#include "RandomEngine.h"
+#include "NumberSerializer.h"
+#include "WeightTable.h"
 
 class SettingsDialog : public QDialog
 {
     Q_OBJECT
 
 public:
+    static constexpr qint64 MaxCount = 1000000000000; // 单次生成数量上限(大数量需流式生成到文件)
+    static constexpr int ExclusionParseDelay = 250;      // 停止输入多久后解析排除文本(毫秒)
+    static constexpr int BackgroundParseLength = 65536;  // 排除文本达到该长度时在后台线程解析
+
     explicit SettingsDialog(QWidget *parent = nullptr);
 
-    void setSettings(int min, int max, int count, bool exclusionEnabled, const QList<int> &excludedNumbers);
+    void setSettings(qint64 min, qint64 max, qint64 count, bool allowDuplicates, EngineType engine,
+                     bool exclusionEnabled, const ExclusionSet &excludedNumbers);
+
+    void setSeedSettings(bool seeded, const QString &seed);
+    void setOutputLayout(NumberSerializer::Layout layout);
+    void setWeightSettings(bool weighted, const QString &weights);
+    void setDistribution(const Distribution::Params &params);
 
-    int getMinValue() const { return minSpinBox->value(); }
-    int getMaxValue() const { return maxSpinBox->value(); }
-    int getCountValue() const { return countSpinBox->value(); }
+    qint64 getMinValue() const { return minSpinBox->value(); }
+    qint64 getMaxValue() const { return maxSpinBox->value(); }
+    qint64 getCountValue() const { return countSpinBox->value(); }
+    bool isDuplicatesAllowed() const { return allowDuplicatesCheckBox->isChecked(); }
+    EngineType getEngineType() const { return EngineType(engineComboBox->currentData().toInt()); }
+    bool isSeededMode() const { return seededCheckBox->isChecked(); }
+    QString getSeedText() const { return seedLineEdit->text(); } // 空字符串表示自动生成
+    NumberSerializer::Layout getOutputLayout() const
+    {
+        return NumberSerializer::Layout(layoutComboBox->currentData().toInt());
+    }
+    bool isWeightedMode() const { return weightedCheckBox->isChecked(); }
+    QString getWeightsText() const { return weightsLineEdit->text(); } // 见 WeightTable
+    Distribution::Params getDistribution() const;
     bool isExclusionEnabled() const { return enableExclusionCheckBox->isChecked(); }
-    QList<int> getExcludedNumbers() const;
+    ExclusionSet getExcludedNumbers() const;
 
     signals:
         void settingsChanged();
 
 private slots:
     void updateRangeLimits();
-    void updateExclusionCheckboxes();
-    void toggleExclusionCheckboxes(bool checked);
+    void updateExclusionGrid();
+    void toggleExclusionGrid(bool checked);
+    void scheduleExclusionParse();
     void updateExclusionFromText();
-    void updateExclusionFromCheckboxes();
+    void updateExclusionFromGrid();
+    void toggleWeights(bool checked);
+    void importWeights();
+    void updateDistributionFields();
     void accept() override;
 
 private:
-    QSpinBox *minSpinBox;
-    QSpinBox *maxSpinBox;
-    QSpinBox *countSpinBox;
+    Int64SpinBox *minSpinBox;
+    Int64SpinBox *maxSpinBox;
+    Int64SpinBox *countSpinBox;
+    QCheckBox *allowDuplicatesCheckBox;
+    QComboBox *engineComboBox;
+    QCheckBox *seededCheckBox;
+    QLineEdit *seedLineEdit;
+    QComboBox *layoutComboBox;
+    QCheckBox *weightedCheckBox;
+    QLineEdit *weightsLineEdit;
+    QPushButton *importWeightsButton;
+    QComboBox *distributionComboBox;
+    QLabel *meanLabel;
+    QDoubleSpinBox *meanSpinBox;
+    QLabel *stddevLabel;
+    QDoubleSpinBox *stddevSpinBox;
+    QLabel *trialsLabel;
+    Int64SpinBox *trialsSpinBox;
+    QLabel *probabilityLabel;
+    QDoubleSpinBox *probabilitySpinBox;
+    QComboBox *boundsComboBox;
     QCheckBox *enableExclusionCheckBox;
     QLineEdit *exclusionLineEdit;
-    QScrollArea *exclusionScrollArea;
-    QWidget *exclusionContainer;
-    QGridLayout *exclusionLayout;
-    QButtonGroup *exclusionButtonGroup;
+    QTableView *exclusionView;
+    ExclusionModel *exclusionModel;
+    QLabel *exclusionTruncatedLabel;
+
+    // 排除文本的延迟解析；每次修改文本编号加一，过期的后台解析结果直接丢弃
+    // 网格勾选后文本也由同一个定时器延迟重写，连续勾选只重写一次
+    QTimer *exclusionParseTimer;
+    quint64 exclusionTextVersion = 0;
+    quint64 exclusionParsedVersion = 0;
+    bool exclusionTextStale = false; // 网格已修改，文本还没有重写
+    QThreadPool exclusionParsePool; // 单线程，析构时等待正在进行的解析
 };
 
 #endif // SETTINGSDIALOG_H
\ No newline at end of file
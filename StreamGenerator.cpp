@@ -0,0 +1,139 @@
+// StreamGenerator.cpp
+#include "StreamGenerator.h"
+#include "UniqueSampler.h"
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <vector>
+
+StreamGenerator::Result StreamGenerator::generateToFile(const QString &filePath, const ParallelGenerator::Params &params,
+                                                        qint64 count, NumberSerializer::Layout layout,
+                                                        const ProgressCallback &progress, QString *errorString)
+{
+    const quint64 available = UniqueSampler::availableCount(params.min, params.max, params.excluded);
+    if (count <= 0 || available == 0 || (params.unique && quint64(count) > available)) {
+        if (errorString) {
+            *errorString = "请求的数量超过了可用数字的数量";
+        }
+        return Result::Failed;
+    }
+
+    // 整个文件复用同一组生成线程
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+
+    auto fill = [&params, &progress, &pool, count](qint64 chunkStart, qint64 chunkCount, qint64 *out) {
+        return ParallelGenerator::generate(
+            params, chunkStart, chunkCount, out,
+            [&progress, chunkStart, count](qint64 done, qint64) {
+                return !progress || progress(chunkStart + done, count);
+            },
+            0, &pool);
+    };
+    return writeChunks(filePath, count, layout, fill, progress, errorString);
+}
+
+StreamGenerator::Result StreamGenerator::generateToFile(const QString &filePath, WeightTable::Sampler *sampler,
+                                                        qint64 count, NumberSerializer::Layout layout,
+                                                        const ProgressCallback &progress, QString *errorString)
+{
+    // 抽取很快，每块结束时报告进度即可
+    auto fill = [sampler](qint64, qint64 chunkCount, qint64 *out) {
+        sampler->fill(std::span<qint64>(out, size_t(chunkCount)));
+        return true;
+    };
+    return writeChunks(filePath, count, layout, fill, progress, errorString);
+}
+
+StreamGenerator::Result StreamGenerator::writeToFile(const QString &filePath, const QList<qint64> &numbers,
+                                                     NumberSerializer::Layout layout, const ProgressCallback &progress,
+                                                     QString *errorString)
+{
+    if (numbers.isEmpty()) {
+        if (errorString) {
+            *errorString = "没有可写入的数字";
+        }
+        return Result::Failed;
+    }
+
+    auto fill = [&numbers](qint64 chunkStart, qint64 chunkCount, qint64 *out) {
+        std::copy_n(numbers.constData() + chunkStart, chunkCount, out);
+        return true;
+    };
+    return writeChunks(filePath, numbers.size(), layout, fill, progress, errorString);
+}
+
+StreamGenerator::Result StreamGenerator::writeChunks(const QString &filePath, qint64 count,
+                                                     NumberSerializer::Layout layout, const FillChunk &fill,
+                                                     const ProgressCallback &progress, QString *errorString)
+{
+    // 写入临时文件，完成后再替换目标文件；取消或失败时不留下半截结果
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return Result::Failed;
+    }
+
+    NumberSerializer serializer(layout, count);
+    const qint64 chunkSize =
+        std::min(count, ParallelGenerator::BlockSize * BlocksPerThread * QThread::idealThreadCount());
+
+    // 两块缓冲交替使用：写入线程写上一块时生成下一块
+    std::vector<qint64> buffers[2] = {std::vector<qint64>(static_cast<size_t>(chunkSize)),
+                                      std::vector<qint64>(static_cast<size_t>(chunkSize))};
+    bool written = true;
+    QThreadPool writer;
+    writer.setMaxThreadCount(1);
+
+    for (qint64 chunkStart = 0, chunk = 0; chunkStart < count; chunkStart += chunkSize, ++chunk) {
+        const qint64 chunkEnd = std::min(count, chunkStart + chunkSize);
+        std::vector<qint64> &numbers = buffers[chunk % 2];
+
+        const bool filled = fill(chunkStart, chunkEnd - chunkStart, numbers.data());
+        // 上一块写完后才能把这一块交给写入线程
+        writer.waitForDone();
+        if (!filled) {
+            file.cancelWriting();
+            return Result::Canceled;
+        }
+        if (!written) {
+            if (errorString) {
+                *errorString = file.errorString();
+            }
+            file.cancelWriting();
+            return Result::Failed;
+        }
+
+        writer.start([&serializer, &file, &numbers, &written, chunkStart, chunkEnd, count]() {
+            written = serializer.write(&file, numbers.data(), chunkEnd - chunkStart)
+                      && (chunkEnd < count || serializer.flush(&file));
+        });
+
+        if (progress && !progress(chunkEnd, count)) {
+            writer.waitForDone();
+            file.cancelWriting();
+            return Result::Canceled;
+        }
+    }
+
+    writer.waitForDone();
+    if (!written) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        file.cancelWriting();
+        return Result::Failed;
+    }
+
+    if (!file.commit()) {
+        if (errorString) {
+            *errorString = file.errorString();
+        }
+        return Result::Failed;
+    }
+
+    return Result::Finished;
+}
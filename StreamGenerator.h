@@ -0,0 +1,51 @@
+// StreamGenerator.h
+#ifndef STREAMGENERATOR_H
+#define STREAMGENERATOR_H
+
+#include <QList>
+#include <QString>
+#include <functional>
+#include "NumberSerializer.h"
+#include "ParallelGenerator.h"
+#include "WeightTable.h"
+
+// 流式生成到文件
+// 按块生成，每块含 QThread::idealThreadCount() × BlocksPerThread 个 ParallelGenerator::BlockSize，
+// 整个文件复用同一个线程池多线程生成；写入线程经 NumberSerializer 格式化并写入上一块的同时生成下一块。
+// 结果既不保存在内存中，也不进入文本框，内存占用只与块大小有关，与数量无关。
+// 不重复抽样的顺序由 RankPermutation 决定，因此无需记录已抽取的数字。
+class StreamGenerator
+{
+public:
+    // 每块中每个生成线程平均分到的 BlockSize 个数
+    static constexpr qint64 BlocksPerThread = 2;
+
+    enum class Result {
+        Finished,
+        Canceled,
+        Failed
+    };
+
+    // 每生成一块调用一次，返回 false 表示取消
+    using ProgressCallback = std::function<bool(qint64 written, qint64 total)>;
+
+    static Result generateToFile(const QString &filePath, const ParallelGenerator::Params &params, qint64 count,
+                                 NumberSerializer::Layout layout, const ProgressCallback &progress,
+                                 QString *errorString = nullptr);
+    // 按权重抽样到文件，由 sampler 依次生成每一块
+    static Result generateToFile(const QString &filePath, WeightTable::Sampler *sampler, qint64 count,
+                                 NumberSerializer::Layout layout, const ProgressCallback &progress,
+                                 QString *errorString = nullptr);
+    // 写入已经生成好的数字，格式与上面相同
+    static Result writeToFile(const QString &filePath, const QList<qint64> &numbers, NumberSerializer::Layout layout,
+                              const ProgressCallback &progress, QString *errorString = nullptr);
+
+private:
+    // 生成 [chunkStart, chunkStart + chunkCount) 的一块，返回 false 表示取消
+    using FillChunk = std::function<bool(qint64 chunkStart, qint64 chunkCount, qint64 *out)>;
+
+    static Result writeChunks(const QString &filePath, qint64 count, NumberSerializer::Layout layout,
+                              const FillChunk &fill, const ProgressCallback &progress, QString *errorString);
+};
+
+#endif // STREAMGENERATOR_H
@@ -0,0 +1,126 @@
+// UniqueSampler.cpp
+#include "UniqueSampler.h"
+#include <numeric>
+#include <vector>
+
+namespace {
+// 稀疏洗牌用的开放寻址表，容量一次分配到位，避免 QHash 逐步扩容带来的内存和时间抖动
+class SwapTable
+{
+public:
+    explicit SwapTable(quint64 count)
+    {
+        quint64 capacity = 16;
+        while (capacity < count * 2) {
+            capacity <<= 1;
+        }
+        m_mask = capacity - 1;
+        m_slots.assign(capacity, Slot{kEmpty, 0});
+    }
+
+    quint64 value(quint64 key) const
+    {
+        for (quint64 i = hash(key);; i = (i + 1) & m_mask) {
+            if (m_slots[i].key == key) {
+                return m_slots[i].value;
+            }
+            if (m_slots[i].key == kEmpty) {
+                return key;
+            }
+        }
+    }
+
+    void insert(quint64 key, quint64 value)
+    {
+        for (quint64 i = hash(key);; i = (i + 1) & m_mask) {
+            if (m_slots[i].key == key || m_slots[i].key == kEmpty) {
+                m_slots[i] = Slot{key, value};
+                return;
+            }
+        }
+    }
+
+private:
+    static constexpr quint64 kEmpty = ~quint64(0); // 序号最大为 2^64 - 2，不会与之冲突
+
+    struct Slot
+    {
+        quint64 key;
+        quint64 value;
+    };
+
+    quint64 hash(quint64 key) const { return (key * 0x9E3779B97F4A7C15ULL) >> 17 & m_mask; }
+
+    quint64 m_mask;
+    std::vector<Slot> m_slots;
+};
+}
+
+quint64 UniqueSampler::availableCount(qint64 min, qint64 max, const ExclusionSet &excluded)
+{
+    if (min > max) {
+        return 0;
+    }
+    return quint64(max) - quint64(min) + 1 - quint64(excluded.size());
+}
+
+QList<qint64> UniqueSampler::sample(qint64 min, qint64 max, const ExclusionSet &excluded, qint64 count,
+                                    EngineType engine, quint64 seed, const ProgressCallback &progress,
+                                    quint64 stream)
+{
+    const quint64 available = availableCount(min, max, excluded);
+    if (count <= 0 || available == 0 || quint64(count) > available) {
+        return QList<qint64>();
+    }
+
+    return withEngine(engine, [&](auto engineType) {
+        using Engine = typename decltype(engineType)::type;
+        return sampleWith<Engine>(min, excluded, count, available, seed, stream, progress);
+    });
+}
+
+template <RandomEngine Engine>
+QList<qint64> UniqueSampler::sampleWith(qint64 min, const ExclusionSet &excluded, qint64 count, quint64 available,
+                                        quint64 seed, quint64 stream, const ProgressCallback &progress)
+{
+    Engine generator(seed, stream);
+
+    QList<qint64> result;
+    result.reserve(count);
+
+    if (available <= quint64(count) * 2) {
+        // 密集：直接对全部序号做前 count 步 Fisher-Yates
+        std::vector<quint64> ranks(available);
+        std::iota(ranks.begin(), ranks.end(), quint64(0));
+        for (quint64 i = 0; i < quint64(count); ++i) {
+            const quint64 j = i + boundedRandom(generator, available - i);
+            std::swap(ranks[i], ranks[j]);
+            result.append(excluded.selectAvailable(min, ranks[i]));
+
+            if (progress && (i + 1) % ProgressInterval == 0 && !progress(qint64(i + 1), count)) {
+                return QList<qint64>();
+            }
+        }
+        return result;
+    }
+
+    // 稀疏：表中只保存被交换过的位置，未出现的位置 i 的值就是 i
+    SwapTable swapped(count);
+    for (quint64 i = 0; i < quint64(count); ++i) {
+        const quint64 j = i + boundedRandom(generator, available - i);
+
+        const quint64 picked = swapped.value(j);
+        if (j != i) {
+            swapped.insert(j, swapped.value(i));
+        }
+        // 位置 i 之后不会再被访问，无需写回
+
+        result.append(excluded.selectAvailable(min, picked));
+
+        if (progress && (i + 1) % ProgressInterval == 0 && !progress(qint64(i + 1), count)) {
+            return QList<qint64>();
+        }
+    }
+
+    return result;
+}
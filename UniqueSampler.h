@@ -0,0 +1,35 @@
+// UniqueSampler.h
+#ifndef UNIQUESAMPLER_H
+#define UNIQUESAMPLER_H
+
+#include <QList>
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+#include <functional>
+
+// 无重复抽样器
+// 在“可用数字序号”空间 [0, 可用数量) 上做 Fisher-Yates 洗牌，然后通过排除集合的选择查询把序号映射回实际数值。
+// 可用数量不超过请求数量的两倍时直接对序号数组洗牌；否则只用开放寻址表记录被交换过的位置(稀疏洗牌)。
+// 每次抽取只做一次有界随机数映射，没有重试循环，内存固定为 O(count)，耗时与请求的密度无关。
+class UniqueSampler
+{
+public:
+    // 每抽取 ProgressInterval 个调用一次，返回 false 表示取消(此时返回空列表)
+    using ProgressCallback = std::function<bool(qint64 done, qint64 total)>;
+    static constexpr qint64 ProgressInterval = 65536;
+
+    // excluded 只能包含 [min, max] 内的数字(见 ExclusionSet::clipped)，
+    // 且 max - min 必须小于 2^64 - 1；stream 选择同一种子下的随机流，批量抽取时每次抽取用不同的流
+    static QList<qint64> sample(qint64 min, qint64 max, const ExclusionSet &excluded, qint64 count,
+                                EngineType engine, quint64 seed, const ProgressCallback &progress = {},
+                                quint64 stream = 0);
+
+    static quint64 availableCount(qint64 min, qint64 max, const ExclusionSet &excluded);
+
+private:
+    template <RandomEngine Engine>
+    static QList<qint64> sampleWith(qint64 min, const ExclusionSet &excluded, qint64 count, quint64 available,
+                                    quint64 seed, quint64 stream, const ProgressCallback &progress);
+};
+
+#endif // UNIQUESAMPLER_H
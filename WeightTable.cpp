@@ -0,0 +1,275 @@
+// WeightTable.cpp
+#include "WeightTable.h"
+#include <QFile>
+#include <QLocale>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QStringView>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+// 不重复抽样时，拒绝次数超过 该值 + (段数 + 已抽数量) / 4 就重建表
+constexpr qint64 kRebuildBaseRejections = 64;
+
+// 解析一个 "数字"、"区间" 或 "*" 和对应的权重
+bool parseEntry(QStringView key, QStringView weightText, WeightTable::Weights *weights)
+{
+    bool ok = false;
+    const double weight = weightText.trimmed().toDouble(&ok);
+    if (!ok || !std::isfinite(weight) || weight < 0) {
+        return false;
+    }
+
+    key = key.trimmed();
+    if (key == u"*") {
+        weights->defaultWeight = weight;
+        return true;
+    }
+
+    // 第一个字符可能是负号，从第二个字符开始找区间分隔符
+    const qsizetype dash = key.indexOf(u'-', 1);
+    bool firstOk = false;
+    bool lastOk = true;
+    const qint64 first = (dash < 0 ? key : key.left(dash)).toLongLong(&firstOk);
+    const qint64 last = dash < 0 ? first : key.mid(dash + 1).toLongLong(&lastOk);
+    if (!firstOk || !lastOk || first > last) {
+        return false;
+    }
+    weights->entries.append({first, last, weight});
+    return true;
+}
+
+// 条目排序并检查重叠
+bool finishEntries(WeightTable::Weights *weights, QString *errorString)
+{
+    QList<WeightTable::Entry> &entries = weights->entries;
+    std::sort(entries.begin(), entries.end(),
+              [](const WeightTable::Entry &a, const WeightTable::Entry &b) { return a.first < b.first; });
+    for (qsizetype i = 1; i < entries.size(); ++i) {
+        if (entries[i].first <= entries[i - 1].last) {
+            *errorString = QString("权重区间重叠: %1 和 %2").arg(entries[i - 1].first).arg(entries[i].first);
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+bool WeightTable::parse(const QString &text, Weights *weights, QString *errorString)
+{
+    *weights = Weights();
+
+    QStringView rest(text);
+    while (!rest.isEmpty()) {
+        qsizetype end = 0;
+        while (end < rest.size() && rest[end] != u',' && rest[end] != u'\n') {
+            ++end;
+        }
+        const QStringView part = rest.left(end).trimmed();
+        rest = rest.mid(std::min(end + 1, rest.size()));
+        if (part.isEmpty()) {
+            continue;
+        }
+
+        const qsizetype colon = part.lastIndexOf(u':');
+        if (colon < 0 || !parseEntry(part.left(colon), part.mid(colon + 1), weights)) {
+            *errorString = QString("无法解析权重: %1").arg(part.toString());
+            return false;
+        }
+    }
+    return finishEntries(weights, errorString);
+}
+
+QString WeightTable::format(const Weights &weights)
+{
+    auto number = [](double weight) { return QString::number(weight, 'g', QLocale::FloatingPointShortest); };
+
+    QStringList parts;
+    parts.reserve(weights.entries.size() + 1);
+    for (const Entry &entry : weights.entries) {
+        const QString key = entry.first == entry.last ? QString::number(entry.first)
+                                                      : QString("%1-%2").arg(entry.first).arg(entry.last);
+        parts.append(key + ':' + number(entry.weight));
+    }
+    if (weights.defaultWeight != 1.0) {
+        parts.append("*:" + number(weights.defaultWeight));
+    }
+    return parts.join(", ");
+}
+
+bool WeightTable::importFile(const QString &filePath, Weights *weights, QString *errorString)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *errorString = file.errorString();
+        return false;
+    }
+
+    *weights = Weights();
+    static const QRegularExpression separator("[\\s,:;]+");
+    int lineNumber = 0;
+    bool dataSeen = false;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QStringList fields = line.split(separator, Qt::SkipEmptyParts);
+        if (fields.size() != 2 || !parseEntry(fields[0], fields[1], weights)) {
+            if (!dataSeen) {
+                dataSeen = true; // 第一行无法解析时当作表头
+                continue;
+            }
+            *errorString = QString("第 %1 行无法解析: %2").arg(lineNumber).arg(line);
+            return false;
+        }
+        dataSeen = true;
+    }
+    return finishEntries(weights, errorString);
+}
+
+WeightTable::WeightTable(qint64 min, qint64 max, const ExclusionSet &excluded, const Weights &weights)
+    : m_min(min), m_max(max), m_excluded(excluded), m_weights(weights)
+{
+    // 把 [min, max] 切成权重相同的段，只保留权重和可用数字都不为 0 的段
+    QList<double> masses;
+    quint64 rank = 0;
+    auto addSegment = [&](qint64 first, qint64 last, double weight) {
+        const quint64 count = quint64(last) - quint64(first) + 1 - quint64(m_excluded.countInRange(first, last));
+        if (count > 0 && weight > 0) {
+            m_segments.append({rank, count, 0, 0});
+            masses.append(weight * double(count));
+            m_positiveCount += count;
+        }
+        rank += count;
+    };
+
+    qint64 next = min; // 下一个还没有归入任何段的数字
+    bool covered = false;
+    for (const Entry &entry : m_weights.entries) {
+        const qint64 first = std::max(entry.first, min);
+        const qint64 last = std::min(entry.last, max);
+        if (first > last) {
+            continue;
+        }
+        if (first > next) {
+            addSegment(next, first - 1, m_weights.defaultWeight);
+        }
+        addSegment(first, last, entry.weight);
+        if (last == max) {
+            covered = true;
+            break;
+        }
+        next = last + 1;
+    }
+    if (!covered) {
+        addSegment(next, max, m_weights.defaultWeight);
+    }
+
+    buildAlias(masses);
+}
+
+void WeightTable::buildAlias(const QList<double> &masses)
+{
+    // Vose 别名法：概率按列数放大，小于 1 的列由大于 1 的列补齐
+    const qsizetype n = masses.size();
+    double total = 0;
+    for (double mass : masses) {
+        total += mass;
+    }
+
+    QList<double> scaled(n);
+    QList<qsizetype> small;
+    QList<qsizetype> large;
+    for (qsizetype i = 0; i < n; ++i) {
+        scaled[i] = masses[i] * double(n) / total;
+        (scaled[i] < 1.0 ? small : large).append(i);
+    }
+
+    auto setColumn = [this](qsizetype column, double probability, qsizetype alias) {
+        const double threshold = std::ldexp(probability, 64);
+        m_segments[column].threshold = threshold >= 18446744073709551616.0 ? std::numeric_limits<quint64>::max()
+                                                                          : quint64(threshold);
+        m_segments[column].alias = quint64(alias);
+    };
+
+    while (!small.isEmpty() && !large.isEmpty()) {
+        const qsizetype less = small.takeLast();
+        const qsizetype more = large.last();
+        setColumn(less, scaled[less], more);
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        if (scaled[more] < 1.0) {
+            large.removeLast();
+            small.append(more);
+        }
+    }
+    // 剩下的列(含浮点误差留下的)概率为 1
+    for (const QList<qsizetype> *rest : {&small, &large}) {
+        for (qsizetype column : *rest) {
+            setColumn(column, 1.0, column);
+        }
+    }
+}
+
+WeightTable::Sampler::Sampler(std::shared_ptr<const WeightTable> table, bool unique, EngineType engine, quint64 seed,
+                              quint64 stream)
+    : m_table(std::move(table)),
+      m_current(m_table),
+      m_unique(unique),
+      m_engine(withEngine(engine, [seed, stream](auto engineType) -> Engines {
+          return typename decltype(engineType)::type(seed, stream);
+      }))
+{
+}
+
+void WeightTable::Sampler::fill(std::span<qint64> out)
+{
+    std::visit([&](auto &engine) { fillWith(engine, out); }, m_engine);
+}
+
+template <RandomEngine Engine>
+void WeightTable::Sampler::fillWith(Engine &engine, std::span<qint64> out)
+{
+    if (!m_unique) {
+        const WeightTable &table = *m_table;
+        for (qint64 &value : out) {
+            value = table.draw(engine);
+        }
+        return;
+    }
+
+    for (qint64 &value : out) {
+        for (;;) {
+            const qint64 candidate = m_current->draw(engine);
+            const qsizetype drawnBefore = m_drawn.size();
+            m_drawn.insert(candidate);
+            if (m_drawn.size() != drawnBefore) {
+                value = candidate;
+                break;
+            }
+            // 已抽到的数字占的权重越来越大时拒绝变多，拒绝的总耗时与重建相当时重建
+            if (++m_rejected >= kRebuildBaseRejections + (m_current->segmentCount() + m_drawn.size()) / 4) {
+                rebuild();
+            }
+        }
+    }
+}
+
+void WeightTable::Sampler::rebuild()
+{
+    QList<ExclusionSet::Interval> intervals = m_table->m_excluded.intervals();
+    intervals.reserve(intervals.size() + m_drawn.size());
+    for (qint64 value : std::as_const(m_drawn)) {
+        intervals.append({value, value});
+    }
+    m_current = std::make_shared<const WeightTable>(m_table->m_min, m_table->m_max,
+                                                    ExclusionSet::fromIntervals(std::move(intervals)),
+                                                    m_table->m_weights);
+    m_rejected = 0;
+    Q_ASSERT(m_current->positiveCount() > 0);
+}
@@ -0,0 +1,105 @@
+// WeightTable.h
+#ifndef WEIGHTTABLE_H
+#define WEIGHTTABLE_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <memory>
+#include <span>
+#include <variant>
+#include "ExclusionSet.h"
+#include "RandomEngine.h"
+
+// 按数字加权的抽样表(别名法)
+// 权重文本由逗号或换行分隔的 "数字:权重"、"区间:权重" 组成，如 "1-10:5, 42:20"；
+// "*:权重" 设置其余数字的权重，默认为 1，写 "*:0" 则只从列出的数字中抽取。
+// [min, max] 按权重条目切成若干段，每段内的数字权重相同；别名表建立在段上，
+// 抽取时先 O(1) 选段，再在段内可用数字中均匀选一个，因此表的大小与条目数成正比，与范围大小无关。
+class WeightTable
+{
+public:
+    struct Entry
+    {
+        qint64 first;
+        qint64 last;   // 闭区间
+        double weight; // 区间内每个数字的权重
+    };
+
+    struct Weights
+    {
+        QList<Entry> entries; // 按 first 排序，互不重叠
+        double defaultWeight = 1.0;
+    };
+
+    // 解析权重文本，失败时给出原因
+    static bool parse(const QString &text, Weights *weights, QString *errorString);
+    static QString format(const Weights &weights);
+    // 从文件导入：每行一个数字(或区间)和权重，以空白、逗号、冒号或分号分隔；# 开头的行和无法解析的表头被忽略
+    static bool importFile(const QString &filePath, Weights *weights, QString *errorString);
+
+    // 在 [min, max] 中除 excluded 外的数字上建表；excluded 须已裁剪到 [min, max]
+    WeightTable(qint64 min, qint64 max, const ExclusionSet &excluded, const Weights &weights);
+
+    qint64 min() const { return m_min; }
+    qint64 max() const { return m_max; }
+    // 权重大于 0 的可用数字个数，不重复抽样的数量不能超过它
+    quint64 positiveCount() const { return m_positiveCount; }
+    qsizetype segmentCount() const { return m_segments.size(); }
+
+    template <RandomEngine Engine>
+    qint64 draw(Engine &engine) const
+    {
+        const quint64 column = boundedRandom(engine, quint64(m_segments.size()));
+        const Segment &segment = m_segments[engine() < m_segments[column].threshold ? column
+                                                                                     : m_segments[column].alias];
+        return m_excluded.selectAvailable(m_min, segment.firstRank + boundedRandom(engine, segment.count));
+    }
+
+    // 带状态的抽取器：可重复时每次直接查表；不重复时拒绝已抽到的数字，
+    // 拒绝次数累计到与重建代价相当时，把已抽到的数字并入排除集合重建表，使拒绝率重新降下来。
+    class Sampler
+    {
+    public:
+        // 不重复抽样时调用方须保证总数量不超过 positiveCount()，已抽到的数字保存在内存中，
+        // 总数量也由 GenerationJob::validate 限制在 MaxInMemoryCount 以内；stream 选择同一种子下的随机流
+        Sampler(std::shared_ptr<const WeightTable> table, bool unique, EngineType engine, quint64 seed,
+                quint64 stream = 0);
+
+        void fill(std::span<qint64> out);
+
+    private:
+        template <RandomEngine Engine>
+        void fillWith(Engine &engine, std::span<qint64> out);
+        void rebuild();
+
+        using Engines = std::variant<Xoshiro256StarStar, Pcg64, Mt19937_64, ChaCha20>;
+
+        std::shared_ptr<const WeightTable> m_table;   // 原始表
+        std::shared_ptr<const WeightTable> m_current; // 不重复抽样时排除了已抽数字的表
+        bool m_unique;
+        Engines m_engine;
+        QSet<qint64> m_drawn;
+        qint64 m_rejected = 0; // 自上次重建以来的拒绝次数
+    };
+
+private:
+    struct Segment
+    {
+        quint64 firstRank; // 段首在可用数字中的序号
+        quint64 count;     // 段内可用数字个数
+        quint64 threshold; // 选中本列时，随机数小于它取本段，否则取 alias 段
+        quint64 alias;
+    };
+
+    void buildAlias(const QList<double> &masses);
+
+    qint64 m_min;
+    qint64 m_max;
+    ExclusionSet m_excluded;
+    Weights m_weights; // 重建时使用
+    QList<Segment> m_segments;
+    quint64 m_positiveCount = 0;
+};
+
+#endif // WEIGHTTABLE_H
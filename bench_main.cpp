@@ -0,0 +1,311 @@
+// bench_main.cpp
+// 热点路径的基准测试：抽样、按权重抽样、非均匀分布、批量抽取、排除网格、结果格式化和历史记录追加
+// 结果以 JSON 输出(每项包含名称、参数、每次耗时和吞吐)，便于在版本之间比较。
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <functional>
+#include <vector>
+#include "BatchFill.h"
+#include "BatchGenerator.h"
+#include "Distribution.h"
+#include "DrawPlan.h"
+#include "ExclusionModel.h"
+#include "GenerationJob.h"
+#include "HistoryLog.h"
+#include "HistoryWriter.h"
+#include "NumberSerializer.h"
+#include "UniqueSampler.h"
+#include "WeightTable.h"
+
+namespace {
+struct Bench
+{
+    QString filter;
+    double minSeconds = 0.2;
+    QJsonArray results;
+
+    // 重复执行 body 直到累计时间不少于 minSeconds，items 为每次处理的数量(数字、记录等)
+    void run(const QString &name, const QJsonObject &params, qint64 items, const std::function<void()> &body)
+    {
+        if (!filter.isEmpty() && !name.contains(filter)) {
+            return;
+        }
+
+        body(); // 预热
+        qint64 iterations = 0;
+        QElapsedTimer timer;
+        timer.start();
+        do {
+            body();
+            ++iterations;
+        } while (timer.nsecsElapsed() < qint64(minSeconds * 1e9));
+        const double seconds = timer.nsecsElapsed() / 1e9;
+
+        QJsonObject result;
+        result["name"] = name;
+        result["params"] = params;
+        result["iterations"] = iterations;
+        result["ns_per_op"] = seconds * 1e9 / double(iterations);
+        result["items_per_second"] = double(items) * double(iterations) / seconds;
+        results.append(result);
+
+        QTextStream(stderr) << name << " " << QJsonDocument(params).toJson(QJsonDocument::Compact) << ": "
+                            << result["ns_per_op"].toDouble() / 1e6 << " ms" << Qt::endl;
+    }
+};
+
+// 在 [min, max] 内均匀分布的 count 个单独排除的数字
+ExclusionSet spreadExclusions(qint64 min, qint64 max, qint64 count)
+{
+    QList<qint64> values;
+    values.reserve(count);
+    const qint64 step = std::max<qint64>(2, (max - min) / std::max<qint64>(1, count));
+    for (qint64 value = min, i = 0; value <= max && i < count; value += step, ++i) {
+        values.append(value);
+    }
+    return ExclusionSet::fromValues(std::move(values));
+}
+
+void benchGeneration(Bench &bench)
+{
+    const qint64 maxCount = 1000000;
+    for (qint64 range : {qint64(1000), qint64(1000000), qint64(1000000000), qint64(1) << 50}) {
+        for (qint64 exclusions : {qint64(0), qint64(100), qint64(10000)}) {
+            if (exclusions * 2 > range) {
+                continue;
+            }
+            const ExclusionSet excluded = spreadExclusions(1, range, exclusions);
+            const qint64 available = qint64(UniqueSampler::availableCount(1, range, excluded));
+
+            // 密度 = 数量 / 可用数量
+            for (double density : {0.01, 0.5, 1.0}) {
+                const qint64 count = std::min(maxCount, std::max<qint64>(1, qint64(double(available) * density)));
+                if (count < qint64(double(available) * density) && density > 0.01) {
+                    continue; // 数量被截断后与 0.01 的情况重复
+                }
+                for (bool unique : {true, false}) {
+                    const QJsonObject params{{"range", range}, {"exclusions", exclusions}, {"density", density},
+                                             {"count", count}, {"unique", unique}};
+                    bench.run("generate", params, count, [&]() {
+                        GenerationJob job({1, range, count, excluded, QString(), unique, 42}, nullptr);
+                        job.run();
+                    });
+                }
+            }
+        }
+    }
+
+    // 设置不变时反复生成：计划只编译一次，之后每次只从计划生成请求
+    const ExclusionSet planExcluded = spreadExclusions(1, 1000000, 10000);
+    bench.run("plan_compile", {{"exclusions", 10000}}, 1,
+              [&]() { DrawPlan(1, 1000000, 10, true, planExcluded); });
+    const DrawPlan plan(1, 1000000, 10, true, planExcluded);
+    bench.run("plan_request", {{"exclusions", 10000}}, 1,
+              [&]() { plan.request(42, EngineType::Xoshiro256StarStar, false); });
+
+    // 按权重抽样：10^5 个条目的别名表，可重复时每次 O(1)
+    WeightTable::Weights weights;
+    for (qint64 i = 0; i < 100000; ++i) {
+        weights.entries.append({1 + i * 10, 1 + i * 10, double(1 + (i * 7919) % 100)});
+    }
+    weights.defaultWeight = 0;
+    const auto table = std::make_shared<const WeightTable>(1, 1000000, ExclusionSet(), weights);
+    bench.run("weighted_build", {{"entries", 100000}}, 100000,
+              [&]() { WeightTable(1, 1000000, ExclusionSet(), weights); });
+    for (bool unique : {false, true}) {
+        const qint64 count = unique ? 50000 : maxCount;
+        bench.run("weighted", {{"entries", 100000}, {"count", count}, {"unique", unique}}, count, [&]() {
+            GenerationJob::Request request{1, 1000000, count, ExclusionSet(), QString(), unique, 42};
+            request.weights = table;
+            GenerationJob job(std::move(request), nullptr);
+            job.run();
+        });
+    }
+
+    // 非均匀分布(可重复)：泊松和二项分布分别覆盖反演和变换拒绝两种情况
+    QList<Distribution::Params> distributions(6);
+    distributions[0].kind = Distribution::Kind::Normal;
+    distributions[0].mean = 500000;
+    distributions[0].stddev = 100000;
+    distributions[1].kind = Distribution::Kind::Exponential;
+    distributions[1].mean = 100000;
+    distributions[2].kind = Distribution::Kind::Poisson;
+    distributions[2].mean = 5;
+    distributions[3].kind = Distribution::Kind::Poisson;
+    distributions[3].mean = 1000;
+    distributions[4].kind = Distribution::Kind::Binomial;
+    distributions[4].trials = 20;
+    distributions[4].probability = 0.3;
+    distributions[5].kind = Distribution::Kind::Binomial;
+    distributions[5].trials = 1000;
+    distributions[5].probability = 0.3;
+    for (const Distribution::Params &distributionParams : distributions) {
+        const auto distribution =
+            std::make_shared<const Distribution>(0, 1000000, ExclusionSet(), distributionParams);
+        const double parameter = distributionParams.kind == Distribution::Kind::Binomial
+                                     ? double(distributionParams.trials) * distributionParams.probability
+                                     : distributionParams.mean;
+        bench.run("distribution",
+                  {{"kind", Distribution::kindName(distributionParams.kind)}, {"mean", parameter}, {"count", maxCount}},
+                  maxCount, [&]() {
+                      GenerationJob::Request request{0, 1000000, maxCount, ExclusionSet(), QString(), false, 42};
+                      request.distribution = distribution;
+                      GenerationJob job(std::move(request), nullptr);
+                      job.run();
+                  });
+    }
+
+    // 批量抽取：每次 49 选 6，写入临时文件
+    QTemporaryDir batchDir;
+    for (bool unique : {true, false}) {
+        const BatchGenerator::Params params{{1, 49, ExclusionSet(), unique, 42}, nullptr, 6, 50000};
+        bench.run("batch_draws", {{"draws", 50000}, {"count", 6}, {"unique", unique}}, params.draws, [&]() {
+            BatchGenerator::generateToFile(batchDir.filePath("draws.csv"), params, {});
+        });
+    }
+
+    // 批量均匀整数的各个实现
+    std::vector<qint64> buffer(maxCount);
+    const BatchFill::Kernel supported = BatchFill::supportedKernel();
+    for (BatchFill::Kernel kernel : {BatchFill::Kernel::Scalar, BatchFill::Kernel::Avx2, BatchFill::Kernel::Avx512}) {
+        if (kernel > supported) {
+            continue;
+        }
+        BatchFill::setActiveKernel(kernel);
+        BatchFill fill(42, 0);
+        bench.run("batch_fill", {{"kernel", BatchFill::kernelName(kernel)}, {"range", 1000000}}, maxCount,
+                  [&]() { fill.fill(buffer, 1000000, 1); });
+    }
+    BatchFill::setActiveKernel(supported);
+}
+
+void benchExclusionGrid(Bench &bench)
+{
+    // 原先按范围逐个重建复选框；现在为 ExclusionModel 的重置加上一屏可见单元格的读取
+    for (qint64 range : {qint64(100), qint64(10000), qint64(1000000), qint64(1000000000)}) {
+        const ExclusionSet excluded = spreadExclusions(1, range, std::min<qint64>(range / 10, 10000));
+        ExclusionModel model;
+        qint64 max = range;
+        bench.run("exclusion_grid", {{"range", range}}, 1, [&]() {
+            max = max == range ? range - 1 : range; // 每次都改变范围，确保触发重置
+            model.setRange(1, max);
+            model.setExcludedNumbers(ExclusionSet());
+            model.setExcludedNumbers(excluded);
+            for (int row = 0; row < std::min(model.rowCount(), 40); ++row) {
+                for (int column = 0; column < ExclusionModel::ColumnCount; ++column) {
+                    model.data(model.index(row, column), Qt::CheckStateRole);
+                    model.data(model.index(row, column), Qt::DisplayRole);
+                }
+            }
+        });
+    }
+}
+
+void benchFormatting(Bench &bench)
+{
+    for (qint64 count : {qint64(1000), qint64(1000000)}) {
+        QList<qint64> numbers(count);
+        for (qint64 i = 0; i < count; ++i) {
+            numbers[i] = (i * 2654435761LL) % 1000000000;
+        }
+        for (NumberSerializer::Layout layout :
+             {NumberSerializer::Layout::Grouped, NumberSerializer::Layout::Csv, NumberSerializer::Layout::OnePerLine}) {
+            bench.run("format", {{"count", count}, {"layout", NumberSerializer::layoutName(layout)}}, count,
+                      [&]() { NumberSerializer::toBytes(numbers, layout); });
+        }
+    }
+}
+
+void benchHistory(Bench &bench)
+{
+    QTemporaryDir dir;
+    const QString logPath = dir.filePath("history.bin");
+
+    for (qint64 count : {qint64(0), qint64(100), qint64(100000)}) {
+        HistoryLog::Entry entry;
+        entry.kind = count == 0 ? HistoryLog::Kind::Seed : HistoryLog::Kind::Numbers;
+        entry.record = {QDateTime::currentDateTime(), 1, 1000000, std::max<qint64>(count, 10), ExclusionSet()};
+        for (qint64 i = 0; i < count; ++i) {
+            entry.numbers.append(1 + (i * 7919) % 1000000);
+        }
+
+        for (int batch : {1, 64}) {
+            const QList<HistoryLog::Entry> entries(batch, entry);
+            bench.run("history_append", {{"numbers", count}, {"batch", batch}}, batch, [&]() {
+                HistoryLog::append(entries, false, logPath);
+            });
+            QFile::remove(logPath);
+            QFile::remove(HistoryLog::indexPath(logPath));
+        }
+    }
+
+    // 通过后台写入线程：计入入队和最终写完的时间
+    HistoryLog::Entry entry;
+    entry.kind = HistoryLog::Kind::Seed;
+    entry.record = {QDateTime::currentDateTime(), 1, 1000000, 10, ExclusionSet()};
+    HistoryWriter::Options options;
+    options.logPath = logPath;
+    options.retention.compress = false;
+    HistoryWriter writer(options);
+    bench.run("history_writer", {{"records", 1000}}, 1000, [&]() {
+        for (int i = 0; i < 1000; ++i) {
+            writer.enqueue(entry);
+        }
+        writer.waitForWritten();
+    });
+}
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rand-full-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("测量生成、排除网格、格式化和历史记录的耗时，结果以 JSON 输出");
+    parser.addHelpOption();
+    QCommandLineOption filterOption("filter", "只运行名称包含该文字的项目", "name");
+    QCommandLineOption minTimeOption("min-time", "每项至少运行的秒数(默认 0.2)", "seconds", "0.2");
+    QCommandLineOption outputOption({"o", "output"}, "写入文件而不是标准输出", "path");
+    parser.addOptions({filterOption, minTimeOption, outputOption});
+    parser.process(app);
+
+    Bench bench;
+    bench.filter = parser.value(filterOption);
+    bench.minSeconds = parser.value(minTimeOption).toDouble();
+
+    benchGeneration(bench);
+    benchExclusionGrid(bench);
+    benchFormatting(bench);
+    benchHistory(bench);
+
+    QJsonObject report;
+    report["version"] = RAND_FULL_VERSION;
+    report["time"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["cpu"] = QSysInfo::currentCpuArchitecture();
+    report["threads"] = QThread::idealThreadCount();
+    report["batch_fill_kernel"] = BatchFill::kernelName(BatchFill::supportedKernel());
+    report["results"] = bench.results;
+    const QByteArray json = QJsonDocument(report).toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+            QTextStream(stderr) << "错误: 无法写入 " << file.fileName() << Qt::endl;
+            return 1;
+        }
+        return 0;
+    }
+    QTextStream(stdout) << json;
+    return 0;
+}
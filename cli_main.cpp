@@ -0,0 +1,210 @@
+// cli_main.cpp
+// 无界面的批处理入口：只依赖 QtCore，不创建窗口和样式表，生成方式和历史记录与界面相同
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QTextStream>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <optional>
+#include "DrawPlan.h"
+#include "GenerationJob.h"
+#include "HistoryWriter.h"
+
+static int fail(const QString &message)
+{
+    QTextStream(stderr) << "错误: " << message << Qt::endl;
+    return 1;
+}
+
+static bool parseInteger(const QString &text, qint64 *value)
+{
+    bool ok;
+    *value = text.toLongLong(&ok);
+    return ok;
+}
+
+// 数字写到标准输出，格式与复制和输出文件相同，末尾补一个换行
+static bool writeToStdout(const QList<qint64> &numbers, NumberSerializer::Layout layout)
+{
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    NumberSerializer serializer(layout, numbers.size());
+    bool ok = serializer.write(&out, numbers.constData(), numbers.size()) && serializer.flush(&out);
+    if (layout == NumberSerializer::Layout::Grouped && numbers.size() % NumberSerializer::ValuesPerLine != 0) {
+        ok = ok && out.write("\n", 1) == 1;
+    }
+    return ok && out.flush();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rand-full-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("生成随机数，结果写到标准输出或文件");
+    parser.addHelpOption();
+
+    QCommandLineOption minOption("min", "最小值(默认 1)", "value", "1");
+    QCommandLineOption maxOption("max", "最大值(默认 100)", "value", "100");
+    QCommandLineOption countOption({"n", "count"}, "数量(默认 10)", "count", "10");
+    QCommandLineOption excludeOption({"x", "exclude"}, "排除的数字，逗号分隔，可写区间如 100-250", "numbers");
+    QCommandLineOption weightsOption({"w", "weights"}, "按权重抽样，权重从文件导入(每行一个数字或区间和权重)", "path");
+    QCommandLineOption duplicatesOption({"d", "duplicates"}, "允许重复");
+    QCommandLineOption seedOption({"s", "seed"}, "种子；指定时为可复现模式，历史记录只保存种子", "seed");
+    QCommandLineOption engineOption({"e", "engine"}, "随机数引擎: xoshiro256**, pcg64, mt19937_64, chacha20", "name");
+    QCommandLineOption layoutOption({"f", "format"}, "输出格式: grouped, csv, lines(默认 grouped)", "layout");
+    QCommandLineOption outputOption({"o", "output"}, "流式生成到文件，不经过内存", "path");
+    QCommandLineOption drawsOption({"k", "draws"}, "批量抽取：独立抽取的次数，每次一行写入 --output 指定的文件",
+                                   "count", "1");
+    QCommandLineOption distributionOption("distribution",
+                                          "分布: uniform, normal, exponential, poisson, binomial(默认 uniform，需与 -d 同用)",
+                                          "name");
+    QCommandLineOption meanOption("mean", "正态分布的均值；指数和泊松分布的均值", "value");
+    QCommandLineOption stddevOption("stddev", "正态分布的标准差(默认 1)", "value", "1");
+    QCommandLineOption trialsOption("trials", "二项分布的试验次数(默认 10)", "count", "10");
+    QCommandLineOption probabilityOption("probability", "二项分布的成功概率(默认 0.5)", "value", "0.5");
+    QCommandLineOption clampOption("clamp", "超出范围的值取最近的端点，而不是重新抽取");
+    QCommandLineOption noHistoryOption("no-history", "不写入历史记录");
+    parser.addOptions({minOption, maxOption, countOption, excludeOption, weightsOption, duplicatesOption, seedOption,
+                       engineOption, layoutOption, outputOption, drawsOption, distributionOption, meanOption,
+                       stddevOption, trialsOption, probabilityOption, clampOption, noHistoryOption});
+    parser.process(app);
+
+    qint64 min, max, count, draws;
+    if (!parseInteger(parser.value(minOption), &min) || !parseInteger(parser.value(maxOption), &max)) {
+        return fail("最小值和最大值必须是整数");
+    }
+    if (!parseInteger(parser.value(countOption), &count) || count <= 0) {
+        return fail("数量必须是正整数");
+    }
+    if (!parseInteger(parser.value(drawsOption), &draws) || draws <= 0) {
+        return fail("抽取次数必须是正整数");
+    }
+    if (draws > std::numeric_limits<qint64>::max() / count) {
+        return fail("抽取的总数量过大");
+    }
+
+    bool seeded = parser.isSet(seedOption);
+    quint64 seed = QRandomGenerator::global()->generate64();
+    if (seeded) {
+        bool ok;
+        seed = parser.value(seedOption).toULongLong(&ok);
+        if (!ok) {
+            return fail("种子必须是 0 到 18446744073709551615 之间的整数");
+        }
+    }
+
+    Distribution::Params distribution;
+    if (parser.isSet(distributionOption)) {
+        const QString name = parser.value(distributionOption);
+        distribution.kind = Distribution::kindFromName(name);
+        if (distribution.kind == Distribution::Kind::Uniform && name != Distribution::kindName(distribution.kind)) {
+            return fail(QString("未知的分布: %1").arg(name));
+        }
+    }
+    bool meanOk = true;
+    if (parser.isSet(meanOption)) {
+        distribution.mean = parser.value(meanOption).toDouble(&meanOk);
+    } else if (distribution.kind != Distribution::Kind::Normal) {
+        distribution.mean = 1; // 指数和泊松分布的均值必须大于 0
+    }
+    bool stddevOk, probabilityOk;
+    distribution.stddev = parser.value(stddevOption).toDouble(&stddevOk);
+    distribution.probability = parser.value(probabilityOption).toDouble(&probabilityOk);
+    if (!meanOk || !stddevOk || !probabilityOk || !parseInteger(parser.value(trialsOption), &distribution.trials)) {
+        return fail("分布参数必须是数字");
+    }
+    distribution.bounds = parser.isSet(clampOption) ? Distribution::Bounds::Clamp : Distribution::Bounds::Reject;
+
+    // 与界面相同：由范围、排除数字、权重和分布编译抽取计划，同时完成检查
+    bool excludedOk;
+    const ExclusionSet excluded = ExclusionSet::fromString(parser.value(excludeOption), &excludedOk);
+    if (!excludedOk) {
+        return fail(QString("无法解析排除数字: %1").arg(parser.value(excludeOption)));
+    }
+    const bool unique = !parser.isSet(duplicatesOption);
+    std::optional<DrawPlan> plan;
+    if (parser.isSet(weightsOption)) {
+        WeightTable::Weights weights;
+        QString errorString;
+        if (!WeightTable::importFile(parser.value(weightsOption), &weights, &errorString)) {
+            return fail(QString("无法读取权重: %1").arg(errorString));
+        }
+        plan.emplace(min, max, count, unique, excluded, &weights, distribution);
+    } else {
+        plan.emplace(min, max, count, unique, excluded, nullptr, distribution);
+    }
+    if (!plan->isValid()) {
+        return fail(plan->errorString());
+    }
+
+    const QString outputPath = parser.value(outputOption);
+    if (outputPath.isEmpty() && count > GenerationJob::MaxInMemoryCount) {
+        return fail(QString("数量超过 %1 时请使用 --output").arg(GenerationJob::MaxInMemoryCount));
+    }
+    if (outputPath.isEmpty() && draws > 1) {
+        return fail("批量抽取需要使用 --output");
+    }
+    if (draws > 1 && count > GenerationJob::MaxBatchCount) {
+        return fail(QString("批量抽取时每次的数量不能超过 %1").arg(GenerationJob::MaxBatchCount));
+    }
+
+    // 名称写错时报错，而不是悄悄换成默认值
+    const NumberSerializer::Layout layout = NumberSerializer::layoutFromName(parser.value(layoutOption));
+    if (parser.isSet(layoutOption) && parser.value(layoutOption) != NumberSerializer::layoutName(layout)) {
+        return fail(QString("未知的输出格式: %1").arg(parser.value(layoutOption)));
+    }
+    const EngineType engine = engineFromName(parser.value(engineOption));
+    if (parser.isSet(engineOption) && parser.value(engineOption) != engineName(engine)) {
+        return fail(QString("未知的随机数引擎: %1").arg(parser.value(engineOption)));
+    }
+
+    // 历史记录写入方式与界面共用配置文件
+    std::unique_ptr<HistoryWriter> historyWriter;
+    if (!parser.isSet(noHistoryOption)) {
+        QSettings settings(QDir::current().filePath("RandomNumberGenerator.ini"), QSettings::IniFormat);
+        // 只抽取一次，不在启动时压缩和清理旧分段，由界面和服务负责
+        HistoryWriter::Options options = HistoryWriter::readOptions(settings);
+        options.maintainOnStart = false;
+        historyWriter = std::make_unique<HistoryWriter>(std::move(options));
+    }
+
+    // 不需要事件循环，直接在主线程中运行任务
+    GenerationJob::Request request = plan->request(seed, engine, seeded, outputPath, layout);
+    request.draws = draws;
+    GenerationJob job(std::move(request), historyWriter.get());
+    job.run();
+
+    if (job.status() == GenerationJob::Status::Failed) {
+        return fail(QString("写入文件失败: %1").arg(job.errorString()));
+    }
+    if (outputPath.isEmpty() && !writeToStdout(job.takeNumbers(), layout)) {
+        return fail("写入标准输出失败");
+    }
+    if (seeded) {
+        QTextStream(stderr) << "种子: " << seed << Qt::endl;
+    }
+    if (draws > 1) {
+        const double seconds = double(job.elapsedNanoseconds()) / 1e9;
+        QTextStream(stderr) << "已完成 " << draws << " 次抽取，用时 " << seconds << " 秒，"
+                            << qint64(double(draws) / std::max(seconds, 1e-9)) << " 次/秒" << Qt::endl;
+    }
+
+    // 写完队列中的记录
+    if (historyWriter) {
+        historyWriter->close();
+        if (!historyWriter->errorString().isEmpty()) {
+            return fail(historyWriter->errorString());
+        }
+    }
+    return 0;
+}
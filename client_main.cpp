@@ -0,0 +1,206 @@
+// client_main.cpp
+// 本地抽取服务的客户端：单次抽取写到标准输出，或以 --load 发送大量流水线请求测量吞吐和延迟
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "DrawClient.h"
+#include "NumberSerializer.h"
+
+static int fail(const QString &message)
+{
+    QTextStream(stderr) << "错误: " << message << Qt::endl;
+    return 1;
+}
+
+struct LoadResult
+{
+    std::vector<qint64> latencies; // 纳秒
+    qint64 numbers = 0;
+    qint64 failures = 0;
+    QString errorString;
+};
+
+// 一个连接上保持 depth 个未完成的请求，直到发送完 total 个
+static void runLoad(const QString &name, const DrawProtocol::Request &request, const ExclusionSet &excluded,
+                    qint64 total, int depth, LoadResult *result)
+{
+    DrawClient client;
+    if (!client.connectToServer(name)) {
+        result->errorString = client.errorString();
+        return;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    QHash<quint32, qint64> sentAt;
+    result->latencies.reserve(size_t(total));
+
+    qint64 sent = 0;
+    auto sendNext = [&]() {
+        const quint32 id = client.send(request, excluded);
+        sentAt.insert(id, clock.nsecsElapsed());
+        ++sent;
+        return id != 0;
+    };
+    while (sent < total && sent < depth) {
+        if (!sendNext()) {
+            result->errorString = client.errorString();
+            return;
+        }
+    }
+
+    DrawProtocol::Response response;
+    for (qint64 received = 0; received < total; ++received) {
+        if (!client.receive(&response)) {
+            result->errorString = client.errorString();
+            return;
+        }
+        result->latencies.push_back(clock.nsecsElapsed() - sentAt.take(response.id));
+        if (response.status == DrawProtocol::Status::Ok) {
+            result->numbers += response.numbers.size();
+        } else {
+            ++result->failures;
+        }
+        if (sent < total && !sendNext()) {
+            result->errorString = client.errorString();
+            return;
+        }
+    }
+}
+
+static int runLoadTest(const QString &name, const DrawProtocol::Request &request, const ExclusionSet &excluded,
+                       qint64 total, int depth, int connections)
+{
+    std::vector<LoadResult> results(size_t(connections));
+    std::vector<std::unique_ptr<QThread>> threads;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < connections; ++i) {
+        // 请求数平均分给各个连接
+        const qint64 share = total / connections + (i < total % connections ? 1 : 0);
+        threads.emplace_back(QThread::create(runLoad, name, request, excluded, share, depth, &results[size_t(i)]));
+        threads.back()->start();
+    }
+    for (auto &thread : threads) {
+        thread->wait();
+    }
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    std::vector<qint64> latencies;
+    qint64 numbers = 0;
+    qint64 failures = 0;
+    for (const LoadResult &result : results) {
+        if (!result.errorString.isEmpty()) {
+            return fail(result.errorString);
+        }
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        numbers += result.numbers;
+        failures += result.failures;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies.empty() ? 0.0 : latencies[size_t(p * double(latencies.size() - 1))] / 1e3;
+    };
+
+    QTextStream out(stdout);
+    out << "requests: " << latencies.size() << Qt::endl;
+    out << "failures: " << failures << Qt::endl;
+    out << "seconds: " << seconds << Qt::endl;
+    out << "requests_per_second: " << latencies.size() / seconds << Qt::endl;
+    out << "numbers_per_second: " << numbers / seconds << Qt::endl;
+    out << "latency_p50_us: " << percentile(0.5) << Qt::endl;
+    out << "latency_p99_us: " << percentile(0.99) << Qt::endl;
+    out << "latency_max_us: " << percentile(1.0) << Qt::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rand-full-client");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("向本地抽取服务发送请求");
+    parser.addHelpOption();
+
+    QCommandLineOption nameOption("name", "服务名称(默认 rand-full)", "name", DrawProtocol::defaultServerName());
+    QCommandLineOption minOption("min", "最小值(默认 1)", "value", "1");
+    QCommandLineOption maxOption("max", "最大值(默认 100)", "value", "100");
+    QCommandLineOption countOption({"n", "count"}, "数量(默认 10)", "count", "10");
+    QCommandLineOption excludeOption({"x", "exclude"}, "排除的数字，逗号分隔，可写区间如 100-250", "numbers");
+    QCommandLineOption duplicatesOption({"d", "duplicates"}, "允许重复");
+    QCommandLineOption seedOption({"s", "seed"}, "种子；不指定时由服务端选择", "seed");
+    QCommandLineOption engineOption({"e", "engine"}, "随机数引擎: xoshiro256**, pcg64, mt19937_64, chacha20", "name");
+    QCommandLineOption layoutOption({"f", "format"}, "输出格式: grouped, csv, lines(默认 grouped)", "layout");
+    QCommandLineOption loadOption("load", "压力测试：发送的请求总数", "requests");
+    QCommandLineOption depthOption("depth", "压力测试：每个连接未完成的请求数(默认 16)", "depth", "16");
+    QCommandLineOption connectionsOption("connections", "压力测试：连接数(默认 1)", "connections", "1");
+    parser.addOptions({nameOption, minOption, maxOption, countOption, excludeOption, duplicatesOption, seedOption,
+                       engineOption, layoutOption, loadOption, depthOption, connectionsOption});
+    parser.process(app);
+
+    DrawProtocol::Request request;
+    bool minOk, maxOk, countOk;
+    request.min = parser.value(minOption).toLongLong(&minOk);
+    request.max = parser.value(maxOption).toLongLong(&maxOk);
+    request.count = parser.value(countOption).toLongLong(&countOk);
+    if (!minOk || !maxOk || !countOk) {
+        return fail("范围和数量必须是整数");
+    }
+    request.unique = !parser.isSet(duplicatesOption);
+    // 名称写错时报错，而不是悄悄换成默认值
+    request.engine = engineFromName(parser.value(engineOption));
+    if (parser.isSet(engineOption) && parser.value(engineOption) != engineName(request.engine)) {
+        return fail(QString("未知的随机数引擎: %1").arg(parser.value(engineOption)));
+    }
+    const NumberSerializer::Layout layout = NumberSerializer::layoutFromName(parser.value(layoutOption));
+    if (parser.isSet(layoutOption) && parser.value(layoutOption) != NumberSerializer::layoutName(layout)) {
+        return fail(QString("未知的输出格式: %1").arg(parser.value(layoutOption)));
+    }
+    if (parser.isSet(seedOption)) {
+        bool ok;
+        request.seed = parser.value(seedOption).toULongLong(&ok);
+        request.seeded = true;
+        if (!ok) {
+            return fail("种子必须是 0 到 18446744073709551615 之间的整数");
+        }
+    }
+    bool excludedOk;
+    const ExclusionSet excluded = ExclusionSet::fromString(parser.value(excludeOption), &excludedOk);
+    if (!excludedOk) {
+        return fail(QString("无法解析排除数字: %1").arg(parser.value(excludeOption)));
+    }
+
+    if (parser.isSet(loadOption)) {
+        const qint64 total = parser.value(loadOption).toLongLong();
+        const int depth = std::max(1, parser.value(depthOption).toInt());
+        const int connections = std::max(1, parser.value(connectionsOption).toInt());
+        return runLoadTest(parser.value(nameOption), request, excluded, std::max<qint64>(1, total), depth,
+                           connections);
+    }
+
+    DrawClient client;
+    DrawProtocol::Response response;
+    if (!client.connectToServer(parser.value(nameOption)) || !client.draw(request, excluded, &response)) {
+        return fail(client.errorString());
+    }
+    if (response.status != DrawProtocol::Status::Ok) {
+        return fail(response.errorString);
+    }
+
+    const QByteArray text = NumberSerializer::toBytes(response.numbers, layout);
+    std::fwrite(text.constData(), 1, size_t(text.size()), stdout);
+    if (!text.endsWith('\n')) {
+        std::fputc('\n', stdout);
+    }
+    QTextStream(stderr) << "种子: " << response.seed << Qt::endl;
+    return 0;
+}
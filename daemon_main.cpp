@@ -0,0 +1,68 @@
+// daemon_main.cpp
+// 常驻的本地抽取服务：进程只启动一次，请求通过本地套接字发送(见 DrawProtocol)
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QSettings>
+#include <QTextStream>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+#include <memory>
+#include "DrawServer.h"
+#include "HistoryWriter.h"
+
+// 信号处理函数中只设置标志，由定时器在主线程中退出事件循环，历史记录队列得以写完
+static std::atomic<bool> quitRequested{false};
+
+static void requestQuit(int)
+{
+    quitRequested.store(true, std::memory_order_relaxed);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("rand-full-daemon");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("在本地套接字上提供随机数抽取服务");
+    parser.addHelpOption();
+    QCommandLineOption nameOption("name", "服务名称(默认 rand-full)", "name", DrawProtocol::defaultServerName());
+    QCommandLineOption noHistoryOption("no-history", "不写入历史记录");
+    parser.addOptions({nameOption, noHistoryOption});
+    parser.process(app);
+
+    std::unique_ptr<HistoryWriter> historyWriter;
+    if (!parser.isSet(noHistoryOption)) {
+        QSettings settings(QDir::current().filePath("RandomNumberGenerator.ini"), QSettings::IniFormat);
+        historyWriter = std::make_unique<HistoryWriter>(HistoryWriter::readOptions(settings));
+    }
+
+    DrawServer server(historyWriter.get());
+    QString errorString;
+    if (!server.listen(parser.value(nameOption), &errorString)) {
+        QTextStream(stderr) << "错误: 无法监听 " << parser.value(nameOption) << ": " << errorString << Qt::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, requestQuit);
+    std::signal(SIGTERM, requestQuit);
+    QTimer quitTimer;
+    QObject::connect(&quitTimer, &QTimer::timeout, &app, [&app]() {
+        if (quitRequested.load(std::memory_order_relaxed)) {
+            app.quit();
+        }
+    });
+    quitTimer.start(200);
+
+    const int exitCode = app.exec();
+    if (historyWriter) {
+        historyWriter->close();
+        if (!historyWriter->errorString().isEmpty()) {
+            QTextStream(stderr) << "错误: " << historyWriter->errorString() << Qt::endl;
+            return 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,29 @@
+// ChiSquare.h
+#ifndef CHISQUARE_H
+#define CHISQUARE_H
+
+#include <QtGlobal>
+#include <cmath>
+#include <span>
+
+// 各格子期望频数相同时的卡方统计量
+inline double chiSquare(std::span<const qint64> observed, double expected)
+{
+    double sum = 0;
+    for (qint64 count : observed) {
+        const double diff = double(count) - expected;
+        sum += diff * diff / expected;
+    }
+    return sum;
+}
+
+// 自由度为 degrees 时显著性约 0.0001 的临界值(Wilson-Hilferty 近似)
+// 测试都使用固定种子，结果是确定的，不会偶发失败
+inline double chiSquareLimit(qint64 degrees)
+{
+    const double k = double(degrees);
+    const double term = 1 - 2 / (9 * k) + 3.72 * std::sqrt(2 / (9 * k));
+    return k * term * term * term;
+}
+
+#endif // CHISQUARE_H
@@ -0,0 +1,138 @@
+// tst_batchfill.cpp
+// 批量生成：AVX2 / AVX-512 实现与标量实现逐位相同，分段填充、discard() 与一次填充等价，结果均匀
+#include <QTest>
+#include <limits>
+#include <vector>
+#include "BatchFill.h"
+#include "ChiSquare.h"
+#include "RandomEngine.h"
+
+Q_DECLARE_METATYPE(BatchFill::Kernel)
+
+namespace {
+const quint64 kRanges[] = {1, 2, 3, 10, 1000003, (1ULL << 32) + 15, (1ULL << 63) + 1,
+                           std::numeric_limits<quint64>::max()};
+const qint64 kOffsets[] = {0, -100, std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::max()};
+
+// 用 kernel 依次填充 lengths 中各段，拼接后返回
+std::vector<qint64> fillWith(BatchFill::Kernel kernel, quint64 range, qint64 offset,
+                             std::initializer_list<qint64> lengths)
+{
+    BatchFill::setActiveKernel(kernel);
+    BatchFill batch(0x5EED, 3);
+    std::vector<qint64> result;
+    for (qint64 length : lengths) {
+        std::vector<qint64> part(static_cast<size_t>(length));
+        batch.fill(part, range, offset);
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    return result;
+}
+}
+
+class TestBatchFill : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void kernelsMatchScalar_data();
+    void kernelsMatchScalar();
+    void matchesXoshiro();
+    void splitFill();
+    void discard();
+    void uniform();
+};
+
+void TestBatchFill::cleanup()
+{
+    BatchFill::setActiveKernel(BatchFill::supportedKernel());
+}
+
+void TestBatchFill::kernelsMatchScalar_data()
+{
+    QTest::addColumn<BatchFill::Kernel>("kernel");
+    QTest::newRow("avx2") << BatchFill::Kernel::Avx2;
+    QTest::newRow("avx512") << BatchFill::Kernel::Avx512;
+}
+
+void TestBatchFill::kernelsMatchScalar()
+{
+    QFETCH(BatchFill::Kernel, kernel);
+    if (BatchFill::supportedKernel() < kernel) {
+        QSKIP("CPU 不支持该实现");
+    }
+
+    // 长度覆盖不足一组、恰好整组和跨组剩余，分段起点不在组边界上
+    for (quint64 range : kRanges) {
+        for (qint64 offset : kOffsets) {
+            const auto lengths = {qint64(0), qint64(1), qint64(7), qint64(8), qint64(9), qint64(1000), qint64(65537)};
+            const std::vector<qint64> scalar = fillWith(BatchFill::Kernel::Scalar, range, offset, lengths);
+            const std::vector<qint64> vector = fillWith(kernel, range, offset, lengths);
+            QVERIFY2(scalar == vector, qPrintable(QString("range %1 offset %2").arg(range).arg(offset)));
+        }
+    }
+}
+
+void TestBatchFill::matchesXoshiro()
+{
+    // 第 0 路与 Xoshiro256StarStar(seed, stream) 配合 boundedRandom() 的结果相同
+    for (quint64 range : kRanges) {
+        BatchFill batch(5, 9);
+        std::vector<qint64> out(BatchFill::Lanes * 200);
+        batch.fill(out, range, -3);
+
+        Xoshiro256StarStar engine(5, 9);
+        for (size_t i = 0; i < out.size(); i += BatchFill::Lanes) {
+            QCOMPARE(out[i], qint64(boundedRandom(engine, range) - 3));
+        }
+    }
+}
+
+void TestBatchFill::splitFill()
+{
+    // 任意分段填充与一次填充相同
+    for (quint64 range : kRanges) {
+        const std::vector<qint64> whole = fillWith(BatchFill::supportedKernel(), range, 0, {4099});
+        const std::vector<qint64> split =
+            fillWith(BatchFill::supportedKernel(), range, 0, {1, 2, 3, 5, 8, 13, 21, 34, 55, 4099 - 142});
+        QVERIFY(whole == split);
+    }
+}
+
+void TestBatchFill::discard()
+{
+    for (quint64 range : kRanges) {
+        for (qint64 skipped : {qint64(1), qint64(8), qint64(1023), qint64(1024), qint64(5000)}) {
+            BatchFill reference(11, 2);
+            std::vector<qint64> expected(size_t(skipped + 100));
+            reference.fill(expected, range);
+
+            BatchFill batch(11, 2);
+            batch.discard(skipped, range);
+            std::vector<qint64> actual(100);
+            batch.fill(actual, range);
+            QVERIFY(std::equal(actual.begin(), actual.end(), expected.begin() + skipped));
+        }
+    }
+}
+
+void TestBatchFill::uniform()
+{
+    constexpr quint64 range = 37;
+    constexpr qint64 n = 370000;
+    BatchFill batch(2024, 0);
+    std::vector<qint64> out(static_cast<size_t>(n));
+    batch.fill(out, range, 100);
+
+    std::vector<qint64> counts(range, 0);
+    for (qint64 value : out) {
+        QVERIFY(value >= 100 && value < 100 + qint64(range));
+        ++counts[size_t(value - 100)];
+    }
+    const double chi = chiSquare(counts, double(n) / double(range));
+    QVERIFY2(chi < chiSquareLimit(range - 1), qPrintable(QString("chi2 %1").arg(chi)));
+}
+
+QTEST_GUILESS_MAIN(TestBatchFill)
+#include "tst_batchfill.moc"
@@ -0,0 +1,206 @@
+// tst_engines.cpp
+// 随机数引擎：同一 (种子, 流号) 可复现，不同流互不相同，boundedRandom() 在各种范围上均匀；
+// DrawEngine / ParallelGenerator 的结果与读取位置和线程数无关
+#include <QTest>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "ChiSquare.h"
+#include "DrawEngine.h"
+#include "ParallelGenerator.h"
+#include "RandomEngine.h"
+
+Q_DECLARE_METATYPE(EngineType)
+
+namespace {
+// 每种引擎一行
+void addEngines()
+{
+    QTest::addColumn<EngineType>("engine");
+    for (EngineType engine :
+         {EngineType::Xoshiro256StarStar, EngineType::Pcg64, EngineType::Mt19937_64, EngineType::ChaCha20}) {
+        QTest::newRow(qPrintable(engineName(engine))) << engine;
+    }
+}
+
+// 引擎 (seed, stream) 的前 count 个输出
+std::vector<quint64> outputs(EngineType type, quint64 seed, quint64 stream, int count)
+{
+    return withEngine(type, [&](auto engineType) {
+        typename decltype(engineType)::type engine(seed, stream);
+        std::vector<quint64> result(static_cast<size_t>(count));
+        for (quint64 &value : result) {
+            value = engine();
+        }
+        return result;
+    });
+}
+
+// 引擎 (seed, stream) 产生的 count 个 [0, range) 内的数
+std::vector<quint64> bounded(EngineType type, quint64 seed, quint64 stream, quint64 range, int count)
+{
+    return withEngine(type, [&](auto engineType) {
+        typename decltype(engineType)::type engine(seed, stream);
+        std::vector<quint64> result(static_cast<size_t>(count));
+        for (quint64 &value : result) {
+            value = boundedRandom(engine, range);
+        }
+        return result;
+    });
+}
+}
+
+class TestEngines : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void deterministic_data() { addEngines(); }
+    void deterministic();
+    void bitsBalanced_data() { addEngines(); }
+    void bitsBalanced();
+    void boundedUniform_data();
+    void boundedUniform();
+    void boundedLargeRange_data() { addEngines(); }
+    void boundedLargeRange();
+    void engineNames();
+    void drawEngineSeek_data() { addEngines(); }
+    void drawEngineSeek();
+    void parallelMatchesSingleThread_data() { addEngines(); }
+    void parallelMatchesSingleThread();
+};
+
+void TestEngines::deterministic()
+{
+    QFETCH(EngineType, engine);
+
+    const std::vector<quint64> reference = outputs(engine, 12345, 7, 1000);
+    QVERIFY(outputs(engine, 12345, 7, 1000) == reference);
+    QVERIFY(outputs(engine, 12345, 8, 1000) != reference);
+    QVERIFY(outputs(engine, 12346, 7, 1000) != reference);
+    // 流号的高位也要参与
+    QVERIFY(outputs(engine, 12345, 7 | (1ULL << 63), 1000) != reference);
+}
+
+void TestEngines::bitsBalanced()
+{
+    QFETCH(EngineType, engine);
+
+    // 每一位为 1 的次数与 n / 2 的偏差不超过 4 个标准差
+    constexpr int n = 100000;
+    std::vector<int> ones(64, 0);
+    for (quint64 value : outputs(engine, 7, 11, n)) {
+        for (int bit = 0; bit < 64; ++bit) {
+            ones[size_t(bit)] += int((value >> bit) & 1);
+        }
+    }
+    const double limit = 4 * std::sqrt(double(n)) / 2;
+    for (int bit = 0; bit < 64; ++bit) {
+        QVERIFY2(std::abs(ones[size_t(bit)] - n / 2) < limit, qPrintable(QString("bit %1").arg(bit)));
+    }
+}
+
+void TestEngines::boundedUniform_data()
+{
+    QTest::addColumn<EngineType>("engine");
+    QTest::addColumn<quint64>("range");
+
+    for (EngineType engine :
+         {EngineType::Xoshiro256StarStar, EngineType::Pcg64, EngineType::Mt19937_64, EngineType::ChaCha20}) {
+        for (quint64 range : {3ULL, 10ULL, 37ULL}) {
+            QTest::addRow("%s %llu", qPrintable(engineName(engine)), range) << engine << range;
+        }
+    }
+}
+
+void TestEngines::boundedUniform()
+{
+    QFETCH(EngineType, engine);
+    QFETCH(quint64, range);
+
+    constexpr int n = 200000;
+    std::vector<qint64> counts(size_t(range), 0);
+    for (quint64 value : bounded(engine, 2024, 3, range, n)) {
+        QVERIFY(value < range);
+        ++counts[size_t(value)];
+    }
+    const double chi = chiSquare(counts, double(n) / double(range));
+    QVERIFY2(chi < chiSquareLimit(qint64(range) - 1), qPrintable(QString("chi2 %1").arg(chi)));
+}
+
+void TestEngines::boundedLargeRange()
+{
+    QFETCH(EngineType, engine);
+
+    // 拒绝区间占 2^64 的四分之一，映射结果按最高两位分成均匀的三段
+    constexpr quint64 range = 0xC000000000000000ULL;
+    constexpr int n = 90000;
+    std::vector<qint64> counts(3, 0);
+    for (quint64 value : bounded(engine, 99, 0, range, n)) {
+        QVERIFY(value < range);
+        ++counts[size_t(value >> 62)];
+    }
+    const double chi = chiSquare(counts, n / 3.0);
+    QVERIFY2(chi < chiSquareLimit(2), qPrintable(QString("chi2 %1").arg(chi)));
+
+    // range 为 1 时总是 0
+    for (quint64 value : bounded(engine, 99, 0, 1, 100)) {
+        QCOMPARE(value, quint64(0));
+    }
+}
+
+void TestEngines::engineNames()
+{
+    for (EngineType engine :
+         {EngineType::Xoshiro256StarStar, EngineType::Pcg64, EngineType::Mt19937_64, EngineType::ChaCha20}) {
+        QVERIFY(engineFromName(engineName(engine)) == engine);
+    }
+    QVERIFY(engineFromName("unknown") == EngineType::Xoshiro256StarStar);
+}
+
+void TestEngines::drawEngineSeek()
+{
+    QFETCH(EngineType, engine);
+
+    // 从任意位置开始读取，结果与从头顺序读取的对应部分相同
+    const ExclusionSet excluded = ExclusionSet::fromValues({-7, 0, 500});
+    constexpr qint64 total = 3 * DrawEngine::BlockSize + 123;
+    DrawEngine sequential(-50, 1000, excluded, engine, 42);
+    std::vector<qint64> reference(static_cast<size_t>(total));
+    sequential.fill(reference);
+
+    for (qint64 start : {qint64(1), DrawEngine::BlockSize - 1, DrawEngine::BlockSize + 77}) {
+        DrawEngine copy = sequential;
+        copy.seek(start);
+        std::vector<qint64> tail(size_t(total - start));
+        copy.fill(tail);
+        QVERIFY2(std::equal(tail.begin(), tail.end(), reference.begin() + start),
+                 qPrintable(QString("start %1").arg(start)));
+    }
+    for (qint64 value : reference) {
+        QVERIFY(value >= -50 && value <= 1000 && !excluded.contains(value));
+    }
+}
+
+void TestEngines::parallelMatchesSingleThread()
+{
+    QFETCH(EngineType, engine);
+
+    ParallelGenerator::Params params;
+    params.min = 1;
+    params.max = 1000000;
+    params.unique = false;
+    params.seed = 2718;
+    params.engine = engine;
+
+    constexpr qint64 first = 1000;
+    constexpr qint64 count = 5 * ParallelGenerator::BlockSize + 17;
+    std::vector<qint64> single(static_cast<size_t>(count));
+    std::vector<qint64> parallel(static_cast<size_t>(count));
+    QVERIFY(ParallelGenerator::generate(params, first, count, single.data(), {}, 1));
+    QVERIFY(ParallelGenerator::generate(params, first, count, parallel.data(), {}, 4));
+    QVERIFY(single == parallel);
+}
+
+QTEST_GUILESS_MAIN(TestEngines)
+#include "tst_engines.moc"
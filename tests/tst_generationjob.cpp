@@ -0,0 +1,83 @@
+// tst_generationjob.cpp
+// 生成任务：同一种子和参数下，生成到文件的结果与重放到内存的结果相同(只保存种子的记录据此重放)
+#include <QTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include "GenerationJob.h"
+#include "StreamGenerator.h"
+
+Q_DECLARE_METATYPE(ExclusionSet)
+
+class TestGenerationJob : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fileMatchesReplay_data();
+    void fileMatchesReplay();
+};
+
+void TestGenerationJob::fileMatchesReplay_data()
+{
+    QTest::addColumn<qint64>("min");
+    QTest::addColumn<qint64>("max");
+    QTest::addColumn<ExclusionSet>("excluded");
+    QTest::addColumn<qint64>("count");
+    QTest::addColumn<bool>("unique");
+
+    constexpr qint64 threshold = GenerationJob::ParallelThreshold;
+    const ExclusionSet gaps = ExclusionSet::fromValues({2, 3, 5, 7, 11, 13});
+    // 低于 ParallelThreshold 的不重复抽样走洗牌，达到后走多线程生成；两边必须按同一标准选择
+    QTest::newRow("sparse shuffle") << qint64(1) << qint64(1000000) << gaps << qint64(10) << true;
+    QTest::newRow("dense shuffle") << qint64(1) << qint64(1500) << gaps << qint64(1000) << true;
+    QTest::newRow("below threshold") << qint64(-threshold) << qint64(threshold) << gaps << threshold - 1 << true;
+    QTest::newRow("at threshold") << qint64(-threshold) << qint64(threshold) << gaps << threshold << true;
+    QTest::newRow("repeats") << qint64(1) << qint64(6) << ExclusionSet() << qint64(5000) << false;
+    // 生成下一块与写入上一块同时进行，跨多块时顺序不能乱
+    const qint64 chunkSize = ParallelGenerator::BlockSize * StreamGenerator::BlocksPerThread * QThread::idealThreadCount();
+    QTest::newRow("several chunks") << qint64(1) << qint64(6) << ExclusionSet() << 2 * chunkSize + 1 << false;
+}
+
+void TestGenerationJob::fileMatchesReplay()
+{
+    QFETCH(qint64, min);
+    QFETCH(qint64, max);
+    QFETCH(ExclusionSet, excluded);
+    QFETCH(qint64, count);
+    QFETCH(bool, unique);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    GenerationJob::Request request;
+    request.min = min;
+    request.max = max;
+    request.excluded = excluded;
+    request.count = count;
+    request.unique = unique;
+    request.seed = 0xC0FFEE;
+    request.seeded = true;
+    request.layout = NumberSerializer::Layout::OnePerLine;
+    request.outputPath = dir.filePath("numbers.txt");
+
+    GenerationJob fileJob(request, nullptr);
+    fileJob.run();
+    QVERIFY2(fileJob.status() == GenerationJob::Status::Finished, qPrintable(fileJob.errorString()));
+
+    // 重放：同样的参数，生成到内存
+    request.outputPath.clear();
+    request.replay = true;
+    GenerationJob replayJob(request, nullptr);
+    replayJob.run();
+    QVERIFY2(replayJob.status() == GenerationJob::Status::Finished, qPrintable(replayJob.errorString()));
+    const QList<qint64> numbers = replayJob.takeNumbers();
+    QCOMPARE(numbers.size(), qsizetype(count));
+
+    QFile file(dir.filePath("numbers.txt"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll() == NumberSerializer::toBytes(numbers, request.layout));
+}
+
+QTEST_GUILESS_MAIN(TestGenerationJob)
+#include "tst_generationjob.moc"
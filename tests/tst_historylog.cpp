@@ -0,0 +1,344 @@
+// tst_historylog.cpp
+// 历史日志：各类记录的头部和变长编码负载写入后读回一致，索引与日志一致，
+// 日志截断、索引缺失或损坏后 repair() 能恢复，分段压缩后仍可读取，多个写入方同时追加时记录不交错
+#include <QTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include "HistoryLog.h"
+
+namespace {
+constexpr qint64 kBaseTime = 1700000000000; // 固定时间，便于按时间查找
+constexpr qint64 kIndexEntrySize = 16;      // 索引项：时间和偏移各 8 字节
+
+DrawRecord makeRecord(qint64 msecs, qint64 min, qint64 max, qint64 count)
+{
+    DrawRecord record;
+    record.time = QDateTime::fromMSecsSinceEpoch(msecs);
+    record.min = min;
+    record.max = max;
+    record.count = count;
+    return record;
+}
+
+// 追加 count 条数字记录，第 i 条的数字为 i, i + 1, ..., i + 9
+void appendNumbers(const QString &logPath, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        QList<qint64> numbers;
+        for (qint64 value = i; value < i + 10; ++value) {
+            numbers.append(value);
+        }
+        QVERIFY(HistoryLog::append(HistoryLog::Kind::Numbers, makeRecord(kBaseTime + i, 0, 100, 10), numbers,
+                                   logPath));
+    }
+}
+
+void verifyNumbers(const HistoryLogReader &reader, int count)
+{
+    QCOMPARE(reader.recordCount(), qint64(count));
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(reader.record(i).time.toMSecsSinceEpoch(), kBaseTime + i);
+        const QList<qint64> numbers = reader.numbers(i);
+        QCOMPARE(numbers.size(), qsizetype(10));
+        QCOMPARE(numbers.first(), qint64(i));
+        QCOMPARE(numbers.last(), qint64(i + 9));
+    }
+}
+
+bool resizeFile(const QString &path, qint64 size)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadWrite) && file.resize(size);
+}
+}
+
+class TestHistoryLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void roundTrip();
+    void varintBoundaries();
+    void repairTruncatedLog();
+    void repairMissingIndex();
+    void repairCorruptIndex();
+    void rotateAndCompress();
+    void maintainOnlyAfterRotate();
+    void concurrentWriters();
+
+private:
+    std::unique_ptr<QTemporaryDir> m_dir;
+    QString m_logPath;
+};
+
+void TestHistoryLog::init()
+{
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+    m_logPath = m_dir->filePath("history.bin");
+}
+
+void TestHistoryLog::roundTrip()
+{
+    DrawRecord numbersRecord = makeRecord(kBaseTime, -1000, 1000, 4);
+    numbersRecord.unique = false;
+    numbersRecord.engine = EngineType::Pcg64;
+    const QList<qint64> numbers{-1000, 1000, 0, 7};
+
+    DrawRecord seedRecord = makeRecord(kBaseTime + 1, 1, 1000000, 500);
+    seedRecord.engine = EngineType::ChaCha20;
+    seedRecord.seed = 0xFEDCBA9876543210ULL;
+    seedRecord.exclusionHash = 0x0123456789ABCDEFULL;
+
+    DrawRecord streamRecord = makeRecord(kBaseTime + 2, 0, 1LL << 40, 100000000);
+    streamRecord.outputPath = "输出/numbers.txt";
+
+    DrawRecord batchRecord = makeRecord(kBaseTime + 3, 1, 49, 6);
+    batchRecord.draws = 17;
+    batchRecord.seed = 42;
+    batchRecord.outputPath = "batch.csv";
+
+    QVERIFY(HistoryLog::append(HistoryLog::Kind::Numbers, numbersRecord, numbers, m_logPath));
+    // 多条记录一次追加
+    QVERIFY(HistoryLog::append({{HistoryLog::Kind::Seed, seedRecord, {}},
+                                {HistoryLog::Kind::Stream, streamRecord, {}},
+                                {HistoryLog::Kind::Batch, batchRecord, {}}},
+                               true, m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(4));
+
+    const HistoryLogReader reader(m_logPath);
+    QCOMPARE(reader.recordCount(), qint64(4));
+    QVERIFY(reader.kind(0) == HistoryLog::Kind::Numbers);
+    QVERIFY(reader.kind(1) == HistoryLog::Kind::Seed);
+    QVERIFY(reader.kind(2) == HistoryLog::Kind::Stream);
+    QVERIFY(reader.kind(3) == HistoryLog::Kind::Batch);
+    QVERIFY(!reader.isReplayable(0));
+    QVERIFY(reader.isReplayable(1));
+
+    const DrawRecord expected[] = {numbersRecord, seedRecord, streamRecord, batchRecord};
+    for (qint64 i = 0; i < 4; ++i) {
+        const DrawRecord record = reader.record(i);
+        const DrawRecord &original = expected[i];
+        QCOMPARE(record.time, original.time);
+        QCOMPARE(record.min, original.min);
+        QCOMPARE(record.max, original.max);
+        QCOMPARE(record.count, original.count);
+        QCOMPARE(record.unique, original.unique);
+        QVERIFY(record.engine == original.engine);
+        QCOMPARE(record.seed, original.seed);
+        QCOMPARE(record.exclusionHash, original.exclusionHash);
+        QCOMPARE(record.outputPath, original.outputPath);
+        QCOMPARE(record.draws, original.draws);
+    }
+    QCOMPARE(reader.numbers(0), numbers);
+    QVERIFY(reader.numbers(1).isEmpty());
+}
+
+void TestHistoryLog::varintBoundaries()
+{
+    // 偏移覆盖 1 到 10 字节的变长编码，包括完整的 64 位范围
+    constexpr qint64 min = std::numeric_limits<qint64>::min();
+    constexpr qint64 max = std::numeric_limits<qint64>::max();
+    QList<qint64> numbers;
+    for (int bits = 0; bits < 64; bits += 7) {
+        numbers.append(qint64(quint64(min) + (1ULL << bits) - 1));
+        numbers.append(qint64(quint64(min) + (1ULL << bits)));
+    }
+    numbers.append(-1);
+    numbers.append(0);
+    numbers.append(max);
+
+    QVERIFY(HistoryLog::append(HistoryLog::Kind::Numbers, makeRecord(kBaseTime, min, max, numbers.size()), numbers,
+                               m_logPath));
+    const HistoryLogReader reader(m_logPath);
+    QCOMPARE(reader.recordCount(), qint64(1));
+    QCOMPARE(reader.numbers(0), numbers);
+}
+
+void TestHistoryLog::repairTruncatedLog()
+{
+    appendNumbers(m_logPath, 3);
+    // 最后一条只写了一半：读取时忽略，repair() 截掉它并重建索引
+    const qint64 fullSize = QFileInfo(m_logPath).size();
+    QVERIFY(resizeFile(m_logPath, fullSize - 5));
+    verifyNumbers(HistoryLogReader(m_logPath), 2);
+
+    QVERIFY(HistoryLog::repair(m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(2));
+    QVERIFY(QFileInfo(m_logPath).size() < fullSize - 5);
+    verifyNumbers(HistoryLogReader(m_logPath), 2);
+
+    // 之后的追加接在完整的记录后面
+    QVERIFY(HistoryLog::append(HistoryLog::Kind::Numbers, makeRecord(kBaseTime + 2, 0, 100, 10),
+                               {2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, m_logPath));
+    QCOMPARE(QFileInfo(m_logPath).size(), fullSize);
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(3));
+    verifyNumbers(HistoryLogReader(m_logPath), 3);
+}
+
+void TestHistoryLog::repairMissingIndex()
+{
+    appendNumbers(m_logPath, 3);
+    QVERIFY(QFile::remove(HistoryLog::indexPath(m_logPath)));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(-1));
+
+    // 没有索引时扫描日志
+    verifyNumbers(HistoryLogReader(m_logPath), 3);
+
+    QVERIFY(HistoryLog::repair(m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(3));
+    verifyNumbers(HistoryLogReader(m_logPath), 3);
+}
+
+void TestHistoryLog::repairCorruptIndex()
+{
+    appendNumbers(m_logPath, 3);
+    const QString indexPath = HistoryLog::indexPath(m_logPath);
+
+    // 索引少了最后一项(追加索引前中断)
+    QVERIFY(resizeFile(indexPath, 2 * kIndexEntrySize));
+    verifyNumbers(HistoryLogReader(m_logPath), 3);
+    QVERIFY(HistoryLog::repair(m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(3));
+
+    // 索引大小不是整项
+    QVERIFY(resizeFile(indexPath, 3 * kIndexEntrySize - 3));
+    verifyNumbers(HistoryLogReader(m_logPath), 3);
+
+    // 追加前会先修复索引
+    QVERIFY(HistoryLog::append(HistoryLog::Kind::Numbers, makeRecord(kBaseTime + 3, 0, 100, 10),
+                               {3, 4, 5, 6, 7, 8, 9, 10, 11, 12}, m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(4));
+    verifyNumbers(HistoryLogReader(m_logPath), 4);
+
+    // 索引内容被改写
+    {
+        QFile index(indexPath);
+        QVERIFY(index.open(QIODevice::ReadWrite));
+        QVERIFY(index.seek(index.size() - 8));
+        const quint64 badOffset = 12345;
+        QCOMPARE(index.write(reinterpret_cast<const char *>(&badOffset), sizeof(badOffset)), qint64(8));
+    }
+    verifyNumbers(HistoryLogReader(m_logPath), 4);
+    QVERIFY(HistoryLog::repair(m_logPath));
+    QCOMPARE(HistoryLog::indexedCount(m_logPath), qint64(4));
+    verifyNumbers(HistoryLogReader(m_logPath), 4);
+}
+
+void TestHistoryLog::rotateAndCompress()
+{
+    appendNumbers(m_logPath, 5);
+
+    HistoryLog::Retention retention;
+    retention.segmentSize = 1; // 有记录就关闭为分段
+    retention.compress = true;
+    retention.retentionSize = 0;
+    HistoryLog::maintain(retention, m_logPath);
+
+    QVERIFY(!QFile::exists(m_logPath));
+    const QStringList segments = HistoryLog::segments(m_logPath);
+    QCOMPARE(segments.size(), qsizetype(1));
+    QVERIFY(HistoryLog::isCompressed(segments.first()));
+    QCOMPARE(HistoryLog::indexedCount(segments.first()), qint64(5));
+    verifyNumbers(HistoryLogReader(segments.first()), 5);
+
+    // 新的当前日志从空开始
+    appendNumbers(m_logPath, 2);
+    verifyNumbers(HistoryLogReader(m_logPath), 2);
+    QCOMPARE(HistoryLog::segments(m_logPath).size(), qsizetype(1));
+}
+
+void TestHistoryLog::maintainOnlyAfterRotate()
+{
+    // 先留下一个未压缩的分段
+    appendNumbers(m_logPath, 5);
+    HistoryLog::Retention retention;
+    retention.segmentSize = 1;
+    retention.compress = false;
+    retention.retentionSize = 0;
+    HistoryLog::maintain(retention, m_logPath);
+    QCOMPARE(HistoryLog::segments(m_logPath).size(), qsizetype(1));
+    QVERIFY(!HistoryLog::isCompressed(HistoryLog::segments(m_logPath).first()));
+
+    // 当前日志未达到阈值，不关闭也不压缩已有分段
+    appendNumbers(m_logPath, 2);
+    retention.segmentSize = 1024 * 1024;
+    retention.compress = true;
+    HistoryLog::maintain(retention, m_logPath, true);
+    QVERIFY(QFile::exists(m_logPath));
+    QVERIFY(!HistoryLog::isCompressed(HistoryLog::segments(m_logPath).first()));
+
+    // 关闭当前日志后压缩全部分段
+    retention.segmentSize = 1;
+    HistoryLog::maintain(retention, m_logPath, true);
+    QVERIFY(!QFile::exists(m_logPath));
+    const QStringList segments = HistoryLog::segments(m_logPath);
+    QCOMPARE(segments.size(), qsizetype(2));
+    for (const QString &segment : segments) {
+        QVERIFY(HistoryLog::isCompressed(segment));
+    }
+}
+
+void TestHistoryLog::concurrentWriters()
+{
+    // 两个写入方(相当于界面和 rand-full-cli)同时追加并维护同一个日志，分段阈值很小，追加期间不断关闭分段
+    constexpr int perWriter = 200;
+    HistoryLog::Retention retention;
+    retention.segmentSize = 4096;
+    retention.compress = false;
+    retention.retentionSize = 0;
+
+    std::atomic<int> failures = 0;
+    auto writer = [&](qint64 id) {
+        for (int i = 0; i < perWriter; ++i) {
+            // 每条记录的数字都是 (写入方, 序号)，足够长，一次追加需要多次 write
+            const QList<qint64> numbers(2000, id * perWriter + i);
+            if (!HistoryLog::append(HistoryLog::Kind::Numbers, makeRecord(kBaseTime + i, 0, 1000, numbers.size()),
+                                    numbers, m_logPath)) {
+                ++failures;
+            }
+            HistoryLog::maintain(retention, m_logPath);
+        }
+    };
+    std::unique_ptr<QThread> first(QThread::create(writer, 0));
+    std::unique_ptr<QThread> second(QThread::create(writer, 1));
+    first->start();
+    second->start();
+    QVERIFY(first->wait(60000));
+    QVERIFY(second->wait(60000));
+    QCOMPARE(failures.load(), 0);
+
+    // 每个分段和当前日志的索引都与日志一致；每个文件中各写入方的记录按顺序出现，合起来恰好各出现一次。
+    // 最后一次维护可能刚把当前日志关闭为分段。
+    QStringList paths = HistoryLog::segments(m_logPath);
+    if (QFile::exists(m_logPath)) {
+        paths.append(m_logPath);
+    }
+    std::vector<bool> seen(2 * perWriter, false);
+    for (const QString &path : paths) {
+        const HistoryLogReader reader(path);
+        QCOMPARE(HistoryLog::indexedCount(path), reader.recordCount());
+        qint64 last[2] = {-1, -1};
+        for (qint64 i = 0; i < reader.recordCount(); ++i) {
+            const QList<qint64> numbers = reader.numbers(i);
+            QCOMPARE(numbers.size(), qsizetype(2000));
+            const qint64 value = numbers.first();
+            QCOMPARE(numbers.last(), value);
+            QVERIFY(value >= 0 && value < 2 * perWriter && !seen[size_t(value)]);
+            seen[size_t(value)] = true;
+            QVERIFY(value > last[value / perWriter]);
+            last[value / perWriter] = value;
+        }
+    }
+    QVERIFY(std::all_of(seen.begin(), seen.end(), [](bool value) { return value; }));
+}
+
+QTEST_GUILESS_MAIN(TestHistoryLog)
+#include "tst_historylog.moc"
@@ -0,0 +1,187 @@
+// tst_historywriter.cpp
+// 后台历史写入：close() 或析构时写完队列中剩余的记录，记录顺序不变，close() 之后的记录被丢弃，
+// 队列按数字总数限制，写入失败由 errorString() 报告
+#include <QTest>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <memory>
+#include "HistoryWriter.h"
+
+Q_DECLARE_METATYPE(HistoryWriter::FlushPolicy)
+
+namespace {
+constexpr qint64 kBaseTime = 1700000000000;
+
+// 第 i 条记录：时间 kBaseTime + i，数字为 i
+HistoryLog::Entry makeEntry(qint64 i)
+{
+    HistoryLog::Entry entry;
+    entry.kind = HistoryLog::Kind::Numbers;
+    entry.record.time = QDateTime::fromMSecsSinceEpoch(kBaseTime + i);
+    entry.record.min = 0;
+    entry.record.max = 1000000;
+    entry.record.count = 1;
+    entry.numbers = {i};
+    return entry;
+}
+
+void verifyEntries(const QString &logPath, qint64 count)
+{
+    const HistoryLogReader reader(logPath);
+    QCOMPARE(reader.recordCount(), count);
+    QCOMPARE(HistoryLog::indexedCount(logPath), count);
+    for (qint64 i = 0; i < count; ++i) {
+        QCOMPARE(reader.record(i).time.toMSecsSinceEpoch(), kBaseTime + i);
+        QCOMPARE(reader.numbers(i), QList<qint64>{i});
+    }
+}
+}
+
+class TestHistoryWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void drainsOnClose_data();
+    void drainsOnClose();
+    void drainsOnDestruction();
+    void waitForWritten();
+    void dropsAfterClose();
+    void boundsQueuedValues();
+    void reportsWriteFailure();
+
+private:
+    HistoryWriter::Options options() const;
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+void TestHistoryWriter::init()
+{
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+}
+
+HistoryWriter::Options TestHistoryWriter::options() const
+{
+    // 合并等待时间远长于测试，只有队列满、waitForWritten() 或停止才会写入
+    HistoryWriter::Options options;
+    options.flushInterval = 60000;
+    options.queueCapacity = 16;
+    options.logPath = m_dir->filePath("history.bin");
+    return options;
+}
+
+void TestHistoryWriter::drainsOnClose_data()
+{
+    QTest::addColumn<HistoryWriter::FlushPolicy>("policy");
+    QTest::newRow("flush") << HistoryWriter::FlushPolicy::Flush;
+    QTest::newRow("sync") << HistoryWriter::FlushPolicy::Sync;
+}
+
+void TestHistoryWriter::drainsOnClose()
+{
+    QFETCH(HistoryWriter::FlushPolicy, policy);
+
+    HistoryWriter::Options options = this->options();
+    options.flushPolicy = policy;
+    HistoryWriter writer(options);
+
+    // 超过队列容量，enqueue() 会阻塞到写入线程取走一批
+    constexpr qint64 count = 100;
+    for (qint64 i = 0; i < count; ++i) {
+        writer.enqueue(makeEntry(i));
+    }
+    QElapsedTimer timer;
+    timer.start();
+    writer.close();
+    // 停止时不再等待合并
+    QVERIFY(timer.elapsed() < options.flushInterval);
+    verifyEntries(options.logPath, count);
+    QVERIFY(writer.errorString().isEmpty());
+}
+
+void TestHistoryWriter::drainsOnDestruction()
+{
+    const HistoryWriter::Options options = this->options();
+    {
+        HistoryWriter writer(options);
+        for (qint64 i = 0; i < 5; ++i) {
+            writer.enqueue(makeEntry(i));
+        }
+    }
+    verifyEntries(options.logPath, 5);
+}
+
+void TestHistoryWriter::waitForWritten()
+{
+    const HistoryWriter::Options options = this->options();
+    HistoryWriter writer(options);
+    for (qint64 i = 0; i < 3; ++i) {
+        writer.enqueue(makeEntry(i));
+    }
+    // 不等合并时间结束，写完后返回，写入线程继续运行
+    writer.waitForWritten();
+    verifyEntries(options.logPath, 3);
+
+    writer.enqueue(makeEntry(3));
+    writer.waitForWritten();
+    verifyEntries(options.logPath, 4);
+}
+
+void TestHistoryWriter::dropsAfterClose()
+{
+    const HistoryWriter::Options options = this->options();
+    HistoryWriter writer(options);
+    writer.enqueue(makeEntry(0));
+    writer.close();
+
+    // 停止后的记录不阻塞也不写入
+    for (qint64 i = 1; i < 100; ++i) {
+        writer.enqueue(makeEntry(i));
+    }
+    writer.waitForWritten();
+    verifyEntries(options.logPath, 1);
+}
+
+void TestHistoryWriter::boundsQueuedValues()
+{
+    // 记录数远低于上限，只有数字总数的限制会让写入线程不等合并时间结束就写入
+    HistoryWriter::Options options = this->options();
+    options.queueCapacity = 1000;
+    options.queueValueCapacity = 10;
+    HistoryWriter writer(options);
+
+    QElapsedTimer timer;
+    timer.start();
+    constexpr qint64 count = 100;
+    for (qint64 i = 0; i < count; ++i) {
+        writer.enqueue(makeEntry(i));
+    }
+    // 数字多于上限的单条记录也能放入
+    HistoryLog::Entry large = makeEntry(count);
+    large.numbers = QList<qint64>(50, 7);
+    large.record.count = large.numbers.size();
+    writer.enqueue(large);
+    QVERIFY(timer.elapsed() < options.flushInterval);
+
+    writer.close();
+    const HistoryLogReader reader(options.logPath);
+    QCOMPARE(reader.recordCount(), count + 1);
+    QCOMPARE(reader.numbers(count), large.numbers);
+}
+
+void TestHistoryWriter::reportsWriteFailure()
+{
+    // 日志所在的目录不存在，追加失败；生成一方不受影响，失败在关闭后报告
+    HistoryWriter::Options options = this->options();
+    options.logPath = m_dir->filePath("missing/history.bin");
+    HistoryWriter writer(options);
+    writer.enqueue(makeEntry(0));
+    writer.close();
+    QVERIFY(!writer.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestHistoryWriter)
+#include "tst_historywriter.moc"
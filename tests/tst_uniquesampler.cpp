@@ -0,0 +1,163 @@
+// tst_uniquesampler.cpp
+// 无重复抽样：结果不重复、不含排除的数字，各数字被抽中的频率以及首个结果的分布均匀
+#include <QTest>
+#include <QSet>
+#include <algorithm>
+#include <vector>
+#include "ChiSquare.h"
+#include "RankPermutation.h"
+#include "UniqueSampler.h"
+
+Q_DECLARE_METATYPE(ExclusionSet)
+Q_DECLARE_METATYPE(EngineType)
+
+class TestUniqueSampler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sample_data();
+    void sample();
+    void sampleAll();
+    void sampleRejectsTooMany();
+    void permutationIsBijection_data();
+    void permutationIsBijection();
+    void permutationIsUniform();
+};
+
+void TestUniqueSampler::sample_data()
+{
+    QTest::addColumn<EngineType>("engine");
+    QTest::addColumn<qint64>("min");
+    QTest::addColumn<qint64>("max");
+    QTest::addColumn<ExclusionSet>("excluded");
+    QTest::addColumn<qint64>("count");
+
+    const ExclusionSet gaps = ExclusionSet::fromValues({3, 7, 8, 9, 20});
+    const ExclusionSet negative = ExclusionSet::fromValues({-3});
+    for (EngineType engine :
+         {EngineType::Xoshiro256StarStar, EngineType::Pcg64, EngineType::Mt19937_64, EngineType::ChaCha20}) {
+        const QByteArray name = engineName(engine).toLatin1();
+        // 可用数量不超过 count 的两倍时走密集洗牌，否则走稀疏洗牌
+        QTest::addRow("%s dense", name.constData()) << engine << qint64(0) << qint64(19) << ExclusionSet() << qint64(15);
+        QTest::addRow("%s sparse", name.constData()) << engine << qint64(0) << qint64(99) << ExclusionSet() << qint64(10);
+        QTest::addRow("%s excluded", name.constData()) << engine << qint64(0) << qint64(29) << gaps << qint64(5);
+        QTest::addRow("%s negative", name.constData()) << engine << qint64(-5) << qint64(4) << negative << qint64(6);
+    }
+}
+
+void TestUniqueSampler::sample()
+{
+    QFETCH(EngineType, engine);
+    QFETCH(qint64, min);
+    QFETCH(qint64, max);
+    QFETCH(ExclusionSet, excluded);
+    QFETCH(qint64, count);
+
+    constexpr int trials = 20000;
+    const qint64 span = max - min + 1;
+    std::vector<qint64> picked(size_t(span), 0);
+    std::vector<qint64> first(size_t(span), 0);
+    for (int trial = 0; trial < trials; ++trial) {
+        const QList<qint64> numbers = UniqueSampler::sample(min, max, excluded, count, engine, quint64(trial));
+        QCOMPARE(qint64(numbers.size()), count);
+        QCOMPARE(qint64(QSet<qint64>(numbers.begin(), numbers.end()).size()), count);
+        for (qint64 number : numbers) {
+            QVERIFY(number >= min && number <= max);
+            QVERIFY(!excluded.contains(number));
+            ++picked[size_t(number - min)];
+        }
+        ++first[size_t(numbers.first() - min)];
+    }
+
+    // 只统计可用的数字
+    std::vector<qint64> pickedAvailable;
+    std::vector<qint64> firstAvailable;
+    for (qint64 value = min; value <= max; ++value) {
+        if (!excluded.contains(value)) {
+            pickedAvailable.push_back(picked[size_t(value - min)]);
+            firstAvailable.push_back(first[size_t(value - min)]);
+        }
+    }
+    const qint64 available = qint64(UniqueSampler::availableCount(min, max, excluded));
+    QCOMPARE(qint64(pickedAvailable.size()), available);
+
+    const double limit = chiSquareLimit(available - 1);
+    const double pickedChi = chiSquare(pickedAvailable, double(trials) * double(count) / double(available));
+    const double firstChi = chiSquare(firstAvailable, double(trials) / double(available));
+    QVERIFY2(pickedChi < limit, qPrintable(QString("picked chi2 %1 >= %2").arg(pickedChi).arg(limit)));
+    QVERIFY2(firstChi < limit, qPrintable(QString("first chi2 %1 >= %2").arg(firstChi).arg(limit)));
+}
+
+void TestUniqueSampler::sampleAll()
+{
+    // 抽完全部可用数字时得到它们的一个排列
+    const ExclusionSet excluded = ExclusionSet::fromValues({-1, 0, 1, 50});
+    const QList<qint64> numbers =
+        UniqueSampler::sample(-10, 100, excluded, 107, EngineType::Xoshiro256StarStar, 42);
+    QCOMPARE(numbers.size(), qsizetype(107));
+
+    QList<qint64> sorted = numbers;
+    std::sort(sorted.begin(), sorted.end());
+    QList<qint64> expected;
+    for (qint64 value = -10; value <= 100; ++value) {
+        if (!excluded.contains(value)) {
+            expected.append(value);
+        }
+    }
+    QCOMPARE(sorted, expected);
+}
+
+void TestUniqueSampler::sampleRejectsTooMany()
+{
+    const ExclusionSet excluded = ExclusionSet::fromValues({5});
+    QVERIFY(UniqueSampler::sample(0, 9, excluded, 10, EngineType::Xoshiro256StarStar, 1).isEmpty());
+    QVERIFY(UniqueSampler::sample(0, 9, excluded, 0, EngineType::Xoshiro256StarStar, 1).isEmpty());
+    QCOMPARE(UniqueSampler::sample(0, 9, excluded, 9, EngineType::Xoshiro256StarStar, 1).size(), qsizetype(9));
+}
+
+void TestUniqueSampler::permutationIsBijection_data()
+{
+    QTest::addColumn<quint64>("size");
+    QTest::addColumn<quint64>("key");
+
+    for (quint64 size : {1ULL, 2ULL, 3ULL, 17ULL, 1000ULL, 4097ULL, 65536ULL}) {
+        for (quint64 key : {0ULL, 1ULL, 0xDEADBEEFULL}) {
+            QTest::addRow("size %llu key %llu", size, key) << size << key;
+        }
+    }
+}
+
+void TestUniqueSampler::permutationIsBijection()
+{
+    QFETCH(quint64, size);
+    QFETCH(quint64, key);
+
+    const RankPermutation permutation(size, key);
+    QCOMPARE(permutation.size(), size);
+    std::vector<bool> seen(size_t(size), false);
+    for (quint64 index = 0; index < size; ++index) {
+        const quint64 value = permutation(index);
+        QVERIFY(value < size);
+        QVERIFY(!seen[size_t(value)]);
+        seen[size_t(value)] = true;
+    }
+}
+
+void TestUniqueSampler::permutationIsUniform()
+{
+    // 固定序号在不同密钥下的输出应均匀分布
+    constexpr quint64 size = 16;
+    constexpr quint64 keys = 32000;
+    for (quint64 index : {0ULL, 7ULL}) {
+        std::vector<qint64> counts(size, 0);
+        for (quint64 key = 0; key < keys; ++key) {
+            ++counts[size_t(RankPermutation(size, key)(index))];
+        }
+        const double chi = chiSquare(counts, double(keys) / double(size));
+        QVERIFY2(chi < chiSquareLimit(size - 1), qPrintable(QString("index %1 chi2 %2").arg(index).arg(chi)));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestUniqueSampler)
+#include "tst_uniquesampler.moc"